@@ -0,0 +1,125 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <functional>
+#include <vector>
+
+#include "mantle/mantle.h"
+#include "slag/slag.h"
+
+using namespace slag;
+
+struct BenchmarkResult {
+    size_t                   operation_count = 0;
+    std::chrono::nanoseconds elapsed         = std::chrono::nanoseconds::zero();
+};
+
+// Keeps a fixed number of nops in flight until enough of them have completed. This is
+// dominated by the per-operation overhead of the reactor (key encoding, lookups, etc.).
+class NopBenchmark final : public ProtoTask {
+public:
+    NopBenchmark(size_t operation_count, size_t queue_depth, BenchmarkResult& result)
+        : operation_count_(operation_count)
+        , started_count_(0)
+        , completed_count_(0)
+        , slots_(queue_depth)
+        , result_(result)
+    {
+    }
+
+    void run() override final {
+        SLAG_PT_BEGIN();
+
+        start_time_ = std::chrono::steady_clock::now();
+        for (Ptr<NopOperation>& slot: slots_) {
+            start(slot);
+        }
+
+        while (completed_count_ < operation_count_) {
+            SLAG_PT_WAIT_READABLE(selector_);
+            while (Event* event = selector_.select()) {
+                Ptr<NopOperation>& slot = event->cast_user_data<Ptr<NopOperation>>();
+                if (slot->result() < 0) {
+                    abort();
+                }
+
+                completed_count_ += 1;
+                slot.reset();
+                start(slot);
+            }
+        }
+
+        result_.operation_count = completed_count_;
+        result_.elapsed = std::chrono::steady_clock::now() - start_time_;
+
+        SLAG_PT_END();
+    }
+
+private:
+    void start(Ptr<NopOperation>& slot) {
+        if (started_count_ < operation_count_) {
+            started_count_ += 1;
+            slot = start_nop_operation();
+            selector_.insert(slot->complete_event(), &slot);
+        }
+    }
+
+private:
+    size_t                                operation_count_;
+    size_t                                started_count_;
+    size_t                                completed_count_;
+    std::vector<Ptr<NopOperation>>        slots_;
+    Selector                              selector_;
+    std::chrono::steady_clock::time_point start_time_;
+    BenchmarkResult&                      result_;
+};
+
+static BenchmarkResult run_nop_benchmark(OperationKeyEncoding encoding, size_t operation_count, size_t queue_depth) {
+    BenchmarkResult result;
+    {
+        Runtime runtime;
+        runtime.spawn_thread<NopBenchmark>(
+            ThreadConfig {
+                .name    = "benchmark",
+                .reactor = ReactorConfig {
+                    .operation_key_encoding = encoding,
+                },
+            },
+            // The thread takes its arguments by value.
+            size_t{operation_count},
+            size_t{queue_depth},
+            std::ref(result)
+        );
+    }
+
+    return result;
+}
+
+int main(int argc, char** argv) {
+    const size_t operation_count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+    const size_t queue_depth = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 256;
+
+    const std::pair<const char*, OperationKeyEncoding> encodings[] = {
+        {"table",          OperationKeyEncoding::TABLE},
+        {"tagged_pointer", OperationKeyEncoding::TAGGED_POINTER},
+    };
+
+    try {
+        for (const auto& [name, encoding]: encodings) {
+            const BenchmarkResult result = run_nop_benchmark(encoding, operation_count, queue_depth);
+            const double seconds = std::chrono::duration<double>(result.elapsed).count();
+
+            std::cout << "nop/" << name
+                      << " depth=" << queue_depth
+                      << " ops=" << result.operation_count
+                      << " ops/sec=" << static_cast<uint64_t>(result.operation_count / seconds)
+                      << std::endl;
+        }
+    }
+    catch (const std::exception& ex) {
+        std::cerr << "Caught: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+#include "catch.hpp"
+#include "ut_runtime.h"
+
+#include <sys/socket.h>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace slag;
+
+namespace {
+
+    constexpr size_t           BUFFER_COUNT = 2;
+    constexpr size_t           BUFFER_SIZE  = 8;
+    constexpr std::string_view PAYLOAD      = "abcdefghijklmnopqrstuvwx"; // Three buffers worth.
+
+    struct RingObservations {
+        bool        multishot_supported  = false;
+        std::string first_received;
+        size_t      first_slice_count    = 0;
+        bool        from_ring            = true; // Every slice was backed by a buffer of the ring.
+        size_t      available_while_held = 0;    // With the first receive's slices still held.
+        int32_t     first_result         = 0;
+        std::string received;                    // By both receives.
+        size_t      available_after      = 0;    // Once everything was dropped again.
+    };
+
+    // Receives more than the ring can hold, returns the buffers, and receives the rest.
+    class ExhaustionTask final : public ProtoTask {
+    public:
+        explicit ExhaustionTask(RingObservations& observations)
+            : observations_(observations)
+        {
+        }
+
+        void run() override {
+            Reactor& reactor = get_reactor();
+
+            SLAG_PT_BEGIN();
+
+            observations_.multishot_supported = reactor.has_capability(Capability::MULTISHOT_RECV);
+
+            {
+                int file_descriptors[2];
+                if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, file_descriptors) < 0) {
+                    throw std::runtime_error("Failed to create socket pair");
+                }
+                receiver_ = make_file_descriptor(file_descriptors[0]);
+                sender_ = make_file_descriptor(file_descriptors[1]);
+
+                if (::send(sender_->borrow(), PAYLOAD.data(), PAYLOAD.size(), 0) != static_cast<ssize_t>(PAYLOAD.size())) {
+                    throw std::runtime_error("Failed to send");
+                }
+            }
+
+            buffer_ring_ = &reactor.create_buffer_ring(BUFFER_COUNT, BUFFER_SIZE);
+
+            // The ring runs dry before everything has been received.
+            operation_ = start_receive_multishot_operation(bind(*receiver_), *buffer_ring_);
+            SLAG_PT_WAIT_COMPLETE(*operation_);
+            observations_.first_result = operation_->result();
+
+            while (std::optional<BufferSlice> slice = operation_->receive()) {
+                observations_.first_received += to_string(*slice);
+                observations_.first_slice_count += 1;
+                observations_.from_ring &= (slice->buffer().pool() == static_cast<BufferPool*>(buffer_ring_));
+                held_.push_back(std::move(*slice));
+            }
+            observations_.available_while_held = buffer_ring_->available_count();
+            observations_.received = observations_.first_received;
+
+            // Finalizing the slices gives their buffers back to the kernel.
+            held_.clear();
+            UT_PT_WAIT_UNTIL(buffer_ring_->available_count() == BUFFER_COUNT);
+
+            // Start another receive for the rest, as a caller does after -ENOBUFS or -EAGAIN.
+            operation_ = start_receive_multishot_operation(bind(*receiver_), *buffer_ring_);
+            while (observations_.received.size() < PAYLOAD.size()) {
+                SLAG_PT_WAIT_READABLE(*operation_);
+                while (std::optional<BufferSlice> slice = operation_->receive()) {
+                    observations_.received += to_string(*slice);
+                }
+                if (operation_->is_complete()) {
+                    operation_ = start_receive_multishot_operation(bind(*receiver_), *buffer_ring_);
+                }
+            }
+
+            operation_->cancel();
+            SLAG_PT_WAIT_COMPLETE(*operation_);
+
+            UT_PT_WAIT_UNTIL(buffer_ring_->available_count() == BUFFER_COUNT);
+            observations_.available_after = buffer_ring_->available_count();
+
+            SLAG_PT_END();
+        }
+
+    private:
+        static std::string to_string(const BufferSlice& slice) {
+            const std::span<const std::byte> bytes = slice.selection();
+            return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+        }
+
+    private:
+        RingObservations&              observations_;
+        Ptr<FileDescriptor>            receiver_;
+        Ptr<FileDescriptor>            sender_;
+        BufferRing*                    buffer_ring_ = nullptr;
+        Ptr<ReceiveMultishotOperation> operation_;
+        std::vector<BufferSlice>       held_;
+    };
+
+}
+
+TEST_CASE("BufferRing") {
+    RingObservations observations;
+
+    SECTION("Buffers are reclaimed when finalized, and receiving resumes after the ring runs dry") {
+        run_root_task<ExhaustionTask>(ThreadConfig{}, std::ref(observations));
+
+        if (observations.multishot_supported) {
+            // One completion per buffer, and then the kernel stops for lack of buffers.
+            CHECK(observations.first_slice_count == BUFFER_COUNT);
+            CHECK(observations.first_result == -ENOBUFS);
+            CHECK(observations.available_while_held == 0);
+        }
+        else {
+            CHECK(observations.first_slice_count == 1);
+            CHECK(observations.first_result == -EAGAIN);
+            CHECK(observations.available_while_held == BUFFER_COUNT - 1);
+        }
+        CHECK(observations.first_received == PAYLOAD.substr(0, observations.first_slice_count * BUFFER_SIZE));
+        CHECK(observations.from_ring);
+        CHECK(observations.received == PAYLOAD);
+        CHECK(observations.available_after == BUFFER_COUNT);
+    }
+}
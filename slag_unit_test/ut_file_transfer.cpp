@@ -0,0 +1,181 @@
+#include "catch.hpp"
+#include "ut_runtime.h"
+
+#include <sys/socket.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace slag;
+using namespace std::chrono_literals;
+
+namespace {
+
+    constexpr const char*      RECEIVER_CHANNEL_NAME = "ut_file_transfer.receiver";
+    constexpr std::string_view PAYLOAD               = "hello";
+
+    struct TransferObservations {
+        bool              supported     = false;
+
+        // The receiver's table has room for one file, which it holds on to with the first message.
+        int32_t           first_error   = -EAGAIN;
+        int32_t           blocked_error = -EAGAIN; // Sending another one while it is held.
+        bool              unregistered  = false;   // The blocked file isn't left in our table.
+        int32_t           retried_error = -EAGAIN; // Once the first message was dropped untaken.
+
+        std::string       received;                // Through the file that was taken.
+
+        std::atomic<bool> holding  = false;
+        std::atomic<bool> released = false;
+        std::atomic<bool> done     = false;
+    };
+
+    // Drops the first file it is sent without taking it, and reads from the second one.
+    class ReceiverTask final : public ProtoTask {
+    public:
+        explicit ReceiverTask(TransferObservations& observations)
+            : observations_(observations)
+            , channel_(RECEIVER_CHANNEL_NAME)
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            SLAG_PT_WAIT_READABLE_FOR(channel_, 5s);
+            held_ = channel_.receive();
+            observations_.holding = true;
+
+            UT_PT_WAIT_UNTIL(observations_.released || observations_.done);
+            held_.reset();
+
+            SLAG_PT_WAIT_READABLE_FOR(channel_, 5s);
+            if (Ptr<Message> message = channel_.receive()) {
+                if (auto transfer = dynamic_cast<FileTransferMessage*>(&*message)) {
+                    if (Ptr<FileDescriptor> file_descriptor = transfer->take()) {
+                        read_ = start_read_operation(bind(*file_descriptor), BufferSlice(bind(*new Buffer(16))));
+                    }
+                }
+            }
+
+            if (read_) {
+                SLAG_PT_WAIT_COMPLETE(*read_);
+                if (read_->result() > 0) {
+                    const std::span<const std::byte> bytes = read_->slice().selection().first(static_cast<size_t>(read_->result()));
+                    observations_.received.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+                }
+            }
+
+            SLAG_PT_END();
+        }
+
+    private:
+        TransferObservations& observations_;
+        Channel               channel_;
+        Ptr<Message>          held_;
+        Ptr<ReadOperation>    read_;
+    };
+
+    // Sends one end of a socket pair at a time to the receiver.
+    class SenderTask final : public ProtoTask {
+    public:
+        explicit SenderTask(TransferObservations& observations)
+            : observations_(observations)
+            , attempt_count_(0)
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            receiver_ = channel_.query(RECEIVER_CHANNEL_NAME);
+            assert(receiver_); // The receiver's thread is started first.
+
+            observations_.supported = get_runtime().reactor(receiver_->thread_index)->has_capability(Capability::FILE_TRANSFER);
+            if (observations_.supported) {
+                first_ = make_socket_pair();
+                transfer_.emplace(channel_, *receiver_, bind(*first_));
+                SLAG_PT_WAIT_COMPLETE(*transfer_);
+                observations_.first_error = transfer_->error();
+
+                UT_PT_WAIT_UNTIL(observations_.holding);
+
+                // The receiver's table is full until the message it holds is finalized.
+                second_ = make_socket_pair();
+                transfer_.emplace(channel_, *receiver_, bind(*second_));
+                SLAG_PT_WAIT_COMPLETE(*transfer_);
+                observations_.blocked_error = transfer_->error();
+                observations_.unregistered = !second_->is_fixed();
+
+                // Dropping the message without taking it frees the slot, which takes a round trip.
+                observations_.released = true;
+                for (attempt_count_ = 0; attempt_count_ < 500; ++attempt_count_) {
+                    transfer_.emplace(channel_, *receiver_, bind(*second_));
+                    SLAG_PT_WAIT_COMPLETE(*transfer_);
+                    observations_.retried_error = transfer_->error();
+                    if (observations_.retried_error != -ENFILE) {
+                        break;
+                    }
+                    SLAG_PT_SLEEP(10ms);
+                }
+            }
+
+            observations_.done = true;
+
+            SLAG_PT_END();
+        }
+
+    private:
+        // Returns one end, with the payload waiting to be read from it.
+        Ref<FileDescriptor> make_socket_pair() {
+            int file_descriptors[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, file_descriptors) < 0) {
+                throw std::runtime_error("Failed to create socket pair");
+            }
+
+            peers_.push_back(make_file_descriptor(file_descriptors[1]));
+            if (::send(file_descriptors[1], PAYLOAD.data(), PAYLOAD.size(), 0) != static_cast<ssize_t>(PAYLOAD.size())) {
+                throw std::runtime_error("Failed to send");
+            }
+
+            return make_file_descriptor(file_descriptors[0]);
+        }
+
+    private:
+        TransferObservations&            observations_;
+        Channel                          channel_;
+        std::optional<ChannelId>         receiver_;
+        Ptr<FileDescriptor>              first_;
+        Ptr<FileDescriptor>              second_;
+        std::vector<Ptr<FileDescriptor>> peers_;
+        std::optional<FileTransfer>      transfer_;
+        size_t                           attempt_count_;
+    };
+
+}
+
+TEST_CASE("FileTransfer") {
+    TransferObservations observations;
+    {
+        ThreadConfig receiver_config;
+        receiver_config.reactor.received_file_table_size = 1;
+
+        Runtime runtime;
+        runtime.spawn_thread<ReceiverTask>(receiver_config, std::ref(observations));
+        runtime.spawn_thread<SenderTask>(ThreadConfig{}, std::ref(observations));
+    }
+
+    if (observations.supported) {
+        CHECK(observations.first_error == 0);
+        CHECK(observations.blocked_error == -ENFILE);
+        CHECK(observations.unregistered);
+        CHECK(observations.retried_error == 0);
+        CHECK(observations.received == PAYLOAD);
+    }
+}
@@ -0,0 +1,122 @@
+#include "catch.hpp"
+#include "ut_runtime.h"
+
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace slag;
+
+namespace {
+
+    constexpr size_t           BUFFER_COUNT = 4;
+    constexpr size_t           BUFFER_SIZE  = 64;
+    constexpr std::string_view PAYLOAD      = "registered";
+
+    struct PoolObservations {
+        size_t                  allocated_count = 0;
+        bool                    exhausted       = false; // Allocating with every buffer in use returned null.
+        uint32_t                dropped_index   = 0;
+        bool                    reclaimed       = false; // The dropped buffer's index was handed out again.
+        std::optional<uint16_t> pool_index;              // The registered index of a pool buffer's slice.
+        std::optional<uint16_t> plain_index;             // Of a buffer from outside the pool.
+        int32_t                 write_result    = 0;
+        int32_t                 read_result     = 0;
+        std::string             received;
+        bool                    left_in_flight  = false; // A fixed read was still waiting at teardown.
+    };
+
+    class PoolTask final : public ProtoTask {
+    public:
+        explicit PoolTask(PoolObservations& observations)
+            : observations_(observations)
+        {
+        }
+
+        void run() override {
+            Reactor& reactor = get_reactor();
+
+            SLAG_PT_BEGIN();
+
+            pool_ = &reactor.create_fixed_buffer_pool(BUFFER_COUNT, BUFFER_SIZE);
+
+            while (Ptr<Buffer> buffer = pool_->allocate()) {
+                held_.push_back(std::move(buffer));
+            }
+            observations_.allocated_count = held_.size();
+            observations_.exhausted = !pool_->allocate() && (pool_->available_count() == 0);
+
+            // Finalizing a buffer gives its index back to the pool.
+            observations_.dropped_index = held_[1]->pool_index();
+            held_.erase(held_.begin() + 1);
+            UT_PT_WAIT_UNTIL(pool_->available_count() == 1);
+            if (Ptr<Buffer> buffer = pool_->allocate()) {
+                observations_.reclaimed = (buffer->pool_index() == observations_.dropped_index);
+                held_.push_back(std::move(buffer));
+            }
+
+            // Slices of pool buffers are written and read with the fixed variants.
+            pipe_ = make_pipe();
+            {
+                std::span<std::byte> storage = held_[0]->storage();
+                memcpy(storage.data(), PAYLOAD.data(), PAYLOAD.size());
+
+                BufferSlice slice(bind(*held_[0]), storage.first(PAYLOAD.size()));
+                observations_.pool_index = registered_buffer_index(slice);
+                write_ = start_write_operation(pipe_->writer(), std::move(slice));
+            }
+            observations_.plain_index = registered_buffer_index(BufferSlice(bind(*new Buffer(BUFFER_SIZE))));
+            SLAG_PT_WAIT_COMPLETE(*write_);
+            observations_.write_result = write_->result();
+
+            read_ = start_read_operation(pipe_->reader(), BufferSlice(bind(*held_[1])));
+            SLAG_PT_WAIT_COMPLETE(*read_);
+            observations_.read_result = read_->result();
+            if (read_->result() > 0) {
+                const std::span<const std::byte> bytes = read_->slice().selection().first(static_cast<size_t>(read_->result()));
+                observations_.received.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            }
+
+            // Nothing is written again, so this is still in flight when the reactor is torn
+            // down, which has to drain it before the buffers are unregistered.
+            read_ = start_read_operation(pipe_->reader(), BufferSlice(bind(*held_[2])));
+            SLAG_PT_YIELD();
+            observations_.left_in_flight = !read_->is_complete() && (reactor.in_flight_count() > 0);
+
+            SLAG_PT_END();
+        }
+
+    private:
+        PoolObservations&        observations_;
+        FixedBufferPool*         pool_ = nullptr;
+        std::vector<Ptr<Buffer>> held_;
+        Ptr<Pipe>                pipe_;
+        Ptr<WriteOperation>      write_;
+        Ptr<ReadOperation>       read_;
+    };
+
+}
+
+TEST_CASE("FixedBufferPool") {
+    PoolObservations observations;
+
+    SECTION("Buffers are handed out until exhausted, reclaimed when finalized, and used for fixed I/O") {
+        run_root_task<PoolTask>(ThreadConfig{}, std::ref(observations));
+
+        CHECK(observations.allocated_count == BUFFER_COUNT);
+        CHECK(observations.exhausted);
+        CHECK(observations.reclaimed);
+
+        CHECK(observations.pool_index.has_value());
+        CHECK(!observations.plain_index.has_value());
+        CHECK(observations.write_result == static_cast<int32_t>(PAYLOAD.size()));
+        CHECK(observations.read_result == static_cast<int32_t>(PAYLOAD.size()));
+        CHECK(observations.received == PAYLOAD);
+
+        CHECK(observations.left_in_flight);
+    }
+}
@@ -0,0 +1,231 @@
+#include "catch.hpp"
+#include "ut_runtime.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <semaphore>
+#include <thread>
+
+using namespace slag;
+using namespace std::chrono_literals;
+
+namespace {
+
+    constexpr const char* RECEIVER_CHANNEL_NAME = "ut_interrupt.receiver";
+
+    struct RetryObservations {
+        bool    interrupted    = false; // The sender had to interrupt the (sleeping) receiver.
+        size_t  retry_count    = 0;
+        int32_t retried_result = -EAGAIN;
+        bool    received       = false;
+        bool    returned       = false; // The message made it back to the sender to be finalized.
+    };
+
+    // Waits for one message, long enough that a lost interrupt shows up as a timeout.
+    class ReceiverTask final : public ProtoTask {
+    public:
+        explicit ReceiverTask(RetryObservations& observations)
+            : observations_(observations)
+            , channel_(RECEIVER_CHANNEL_NAME)
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            SLAG_PT_WAIT_READABLE_FOR(channel_, 5s);
+            observations_.received = static_cast<bool>(channel_.receive());
+
+            SLAG_PT_END();
+        }
+
+    private:
+        RetryObservations& observations_;
+        Channel            channel_;
+    };
+
+    // Sends a message to the receiver once it is asleep, and fails the interrupt that it starts.
+    class SenderTask final : public ProtoTask {
+    public:
+        explicit SenderTask(RetryObservations& observations)
+            : observations_(observations)
+            , wait_count_(0)
+        {
+        }
+
+        void run() override {
+            Router& router = get_router();
+
+            SLAG_PT_BEGIN();
+
+            receiver_ = channel_.query(RECEIVER_CHANNEL_NAME);
+            assert(receiver_); // The receiver's thread is started first.
+
+            // Give the receiver time to block in its reactor.
+            SLAG_PT_SLEEP(10ms);
+
+            channel_.send(*receiver_, bind(*new Message));
+            SLAG_PT_YIELD(); // The router flushes the link, and starts the interrupt.
+
+            interrupt_ = router.interrupt_operation(receiver_->thread_index);
+            observations_.interrupted = interrupt_ && (interrupt_->state() == OperationState::OPERATION_PENDING);
+            if (observations_.interrupted) {
+                // Fail it before the reactor submits it, as if the receiver's completion queue was full.
+                interrupt_->writable_event().reset();
+                interrupt_->handle_result(interrupt_->key(), -EOVERFLOW, 0);
+
+                UT_PT_WAIT_UNTIL((router.metrics().interrupt_retry_count > 0) && interrupt_->is_complete());
+                observations_.retry_count = router.metrics().interrupt_retry_count;
+                observations_.retried_result = interrupt_->result();
+            }
+
+            // The message comes back here once the receiver is done with it.
+            for (wait_count_ = 0; (wait_count_ < 5000) && (router.metrics().finalize_count == 0); ++wait_count_) {
+                SLAG_PT_SLEEP(1ms);
+            }
+            observations_.returned = router.metrics().finalize_count > 0;
+
+            SLAG_PT_END();
+        }
+
+    private:
+        RetryObservations&       observations_;
+        Channel                  channel_;
+        std::optional<ChannelId> receiver_;
+        Ptr<InterruptOperation>  interrupt_;
+        size_t                   wait_count_;
+    };
+
+}
+
+TEST_CASE("Doorbell") {
+    Doorbell doorbell;
+
+    SECTION("Only the first sender interrupts a sleeping owner") {
+        REQUIRE(doorbell.sleep());
+
+        CHECK(doorbell.ring(3));
+        CHECK(!doorbell.ring(5));
+        CHECK(!doorbell.ring(3));
+
+        CHECK(doorbell.wake() == ((1ull << 3) | (1ull << 5)));
+        CHECK(doorbell.wake() == 0);
+    }
+
+    SECTION("Senders don't interrupt an awake owner") {
+        CHECK(!doorbell.ring(1));
+        CHECK(doorbell.wake() == (1ull << 1));
+    }
+
+    SECTION("The owner doesn't sleep after being rung") {
+        CHECK(!doorbell.ring(2));
+        CHECK(!doorbell.sleep());
+
+        // Still awake, so it has to be rung again after it looks.
+        CHECK(doorbell.wake() == (1ull << 2));
+        CHECK(!doorbell.ring(2));
+    }
+
+    SECTION("Ringing starts over once the owner looks") {
+        REQUIRE(doorbell.sleep());
+        CHECK(doorbell.ring(7));
+        CHECK(doorbell.wake() == (1ull << 7));
+
+        REQUIRE(doorbell.sleep());
+        CHECK(doorbell.ring(7));
+    }
+
+    SECTION("Concurrent senders never leave the owner asleep") {
+        constexpr size_t sender_count = 2;
+        constexpr size_t send_count = 100'000;
+
+        std::atomic<size_t> sent_count = 0;
+        std::counting_semaphore<> interrupts(0);
+
+        std::thread senders[sender_count];
+        for (size_t index = 0; index < sender_count; ++index) {
+            senders[index] = std::thread([&, source = static_cast<ThreadIndex>(index + 1)]() {
+                for (size_t count = 0; count < send_count; ++count) {
+                    sent_count.fetch_add(1);
+                    if (doorbell.ring(source)) {
+                        interrupts.release();
+                    }
+                }
+            });
+        }
+
+        // The owner only blocks if it hasn't been rung, and then it has to be interrupted.
+        bool lost_interrupt = false;
+        size_t block_count = 0;
+        while (true) {
+            doorbell.wake();
+            if (sent_count.load() == sender_count * send_count) {
+                break;
+            }
+
+            if (doorbell.sleep()) {
+                block_count += 1;
+                if (!interrupts.try_acquire_for(5s)) {
+                    lost_interrupt = true;
+                    break;
+                }
+            }
+        }
+
+        for (std::thread& sender: senders) {
+            sender.join();
+        }
+
+        CHECK(!lost_interrupt);
+        INFO("The owner blocked " << block_count << " times");
+    }
+}
+
+TEST_CASE("InterruptOperation restart") {
+    const Interrupt interrupt = {
+        .source = 1,
+        .reason = InterruptReason::LINK,
+    };
+
+    // The selector stands in for the reactor's pending cancels, which the operation stays
+    // attached to after it is prepared. The reactor schedules restarted operations it finds
+    // there like new ones.
+    Selector pending_cancels;
+    InterruptOperation operation(nullptr, interrupt);
+    pending_cancels.insert<PollableType::WRITABLE>(operation);
+    CHECK(pending_cancels.ready_count() == 1);
+
+    // Canceling it before it is submitted completes it without leaving the selector.
+    operation.cancel();
+    REQUIRE(operation.is_complete());
+    CHECK(operation.result() == -ECANCELED);
+    CHECK(operation.writable_event().is_linked());
+    CHECK(pending_cancels.ready_count() == 0);
+
+    // Restarting it queues it again without scheduling it explicitly.
+    operation.restart();
+    CHECK(operation.state() == OperationState::OPERATION_PENDING);
+    CHECK(!operation.is_complete());
+    CHECK(operation.result() == -EAGAIN);
+    CHECK(pending_cancels.ready_count() == 1);
+
+    CHECK(pending_cancels.select() == &operation.writable_event());
+    CHECK(!operation.writable_event().is_linked());
+}
+
+TEST_CASE("Router retries lost interrupts") {
+    RetryObservations observations;
+    {
+        Runtime runtime;
+        runtime.spawn_thread<ReceiverTask>(ThreadConfig{}, std::ref(observations));
+        runtime.spawn_thread<SenderTask>(ThreadConfig{}, std::ref(observations));
+    }
+
+    REQUIRE(observations.interrupted);
+    CHECK(observations.retry_count == 1);
+    CHECK(observations.retried_result >= 0);
+    CHECK(observations.received);
+    CHECK(observations.returned);
+}
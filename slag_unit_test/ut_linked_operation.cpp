@@ -0,0 +1,265 @@
+#include "catch.hpp"
+#include "ut_runtime.h"
+
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace slag;
+using namespace std::chrono_literals;
+
+namespace {
+
+    struct ChainObservations {
+        int32_t              chain_result    = -EAGAIN;
+        std::vector<int32_t> step_results;
+        bool                 steps_completed = false; // Every step had completed when the chain did.
+        std::string          piped;                   // What the steps left in the pipe.
+        int32_t              next_result     = -EAGAIN; // A nop started after the chain.
+    };
+
+    Ref<Buffer> make_text_buffer(const std::string_view text) {
+        Ref<Buffer> buffer = bind(*new Buffer(text.size()));
+        std::memcpy(buffer->storage().data(), text.data(), text.size());
+        return buffer;
+    }
+
+    // Starts a chain, waits for it to complete, and records the outcome of each step.
+    class ChainTask : public ProtoTask {
+    public:
+        explicit ChainTask(ChainObservations& observations)
+            : observations_(observations)
+            , pipe_(make_pipe())
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            chain_ = start();
+            if (cancel_after_submission()) {
+                SLAG_PT_SLEEP(10ms); // Long enough for the event loop to submit it.
+                chain_->cancel();
+            }
+
+            SLAG_PT_WAIT_COMPLETE(*chain_);
+            observations_.chain_result = chain_->result();
+            observations_.steps_completed = true;
+            for (size_t index = 0; index < chain_->step_count(); ++index) {
+                observations_.steps_completed &= chain_->step(index).is_complete();
+            }
+            record();
+
+            {
+                int available = 0;
+                (void)ioctl(pipe_->reader()->borrow(), FIONREAD, &available);
+
+                std::string piped(static_cast<size_t>(available), '\0');
+                if (available > 0) {
+                    (void)::read(pipe_->reader()->borrow(), piped.data(), piped.size());
+                }
+                observations_.piped = std::move(piped);
+            }
+
+            // The reactor keeps going afterwards.
+            next_ = start_nop_operation();
+            SLAG_PT_WAIT_COMPLETE(*next_);
+            observations_.next_result = next_->result();
+
+            SLAG_PT_END();
+        }
+
+    protected:
+        virtual Ref<LinkedOperation> start() = 0;
+        virtual void record() = 0;
+
+        virtual bool cancel_after_submission() const {
+            return false;
+        }
+
+        Ref<WriteOperation> create_write(const std::string_view text) {
+            return create_operation<WriteOperation>(pipe_->writer(), BufferSlice(make_text_buffer(text)));
+        }
+
+    protected:
+        ChainObservations&    observations_;
+        Ref<Pipe>             pipe_;
+        Ptr<LinkedOperation>  chain_;
+        Ptr<NopOperation>     next_;
+    };
+
+    // Each write only starts once the one before it has finished.
+    class OrderTask final : public ChainTask {
+    public:
+        using ChainTask::ChainTask;
+
+    private:
+        Ref<LinkedOperation> start() override {
+            Ref<WriteOperation> first = create_write("a");
+            Ref<WriteOperation> second = create_write("bc");
+            Ref<WriteOperation> third = create_write("def");
+            first_ = first;
+            second_ = second;
+            third_ = third;
+            return start_linked_operation(first, second, third);
+        }
+
+        void record() override {
+            observations_.step_results = {first_->result(), second_->result(), third_->result()};
+        }
+
+    private:
+        Ptr<WriteOperation> first_;
+        Ptr<WriteOperation> second_;
+        Ptr<WriteOperation> third_;
+    };
+
+    // The read at the head of the chain blocks on the empty pipe until the chain is canceled.
+    class HeadCancelTask final : public ChainTask {
+    public:
+        using ChainTask::ChainTask;
+
+    private:
+        Ref<LinkedOperation> start() override {
+            Ref<ReadOperation> read = create_operation<ReadOperation>(pipe_->reader(), BufferSlice(bind(*new Buffer(16))));
+            Ref<WriteOperation> write = create_write("x");
+            Ref<NopOperation> nop = create_operation<NopOperation>();
+            read_ = read;
+            write_ = write;
+            nop_ = nop;
+            return start_linked_operation(read, write, nop);
+        }
+
+        void record() override {
+            observations_.step_results = {read_->result(), write_->result(), nop_->result()};
+        }
+
+        bool cancel_after_submission() const override {
+            return true;
+        }
+
+    private:
+        Ptr<ReadOperation>  read_;
+        Ptr<WriteOperation> write_;
+        Ptr<NopOperation>   nop_;
+    };
+
+    // Reading from the write end of the pipe fails, and breaks the chain.
+    class FailureTask final : public ChainTask {
+    public:
+        using ChainTask::ChainTask;
+
+    private:
+        Ref<LinkedOperation> start() override {
+            Ref<ReadOperation> read = create_operation<ReadOperation>(pipe_->writer(), BufferSlice(bind(*new Buffer(16))));
+            Ref<WriteOperation> write = create_write("x");
+            Ref<NopOperation> nop = create_operation<NopOperation>();
+            read_ = read;
+            write_ = write;
+            nop_ = nop;
+            return start_linked_operation(read, write, nop);
+        }
+
+        void record() override {
+            observations_.step_results = {read_->result(), write_->result(), nop_->result()};
+        }
+
+    private:
+        Ptr<ReadOperation>  read_;
+        Ptr<WriteOperation> write_;
+        Ptr<NopOperation>   nop_;
+    };
+
+    // A chain of nops with one more entry (the trailing nop of the chain) than the submission queue.
+    class OversizedTask final : public ChainTask {
+    public:
+        OversizedTask(size_t step_count, ChainObservations& observations)
+            : ChainTask(observations)
+            , step_count_(step_count)
+        {
+        }
+
+    private:
+        Ref<LinkedOperation> start() override {
+            Reactor& reactor = get_reactor();
+
+            std::vector<Ref<Operation>> steps;
+            for (size_t index = 0; index < step_count_; ++index) {
+                Ref<NopOperation> nop = create_operation<NopOperation>();
+                steps.push_back(bind(static_cast<Operation&>(*nop)));
+                nops_.push_back(std::move(nop));
+            }
+
+            // This is what `start_linked_operation` does, for a number of steps picked at runtime.
+            auto op = reactor.create_operation<LinkedOperation>(std::move(steps));
+            reactor.schedule_operation(*op);
+            return op;
+        }
+
+        void record() override {
+            for (const Ptr<NopOperation>& nop: nops_) {
+                observations_.step_results.push_back(nop->result());
+            }
+        }
+
+    private:
+        size_t                         step_count_;
+        std::vector<Ptr<NopOperation>> nops_;
+    };
+
+}
+
+TEST_CASE("LinkedOperation") {
+    ChainObservations observations;
+
+    SECTION("Steps run in order, and the chain completes after them") {
+        run_root_task<OrderTask>(ThreadConfig{}, std::ref(observations));
+
+        CHECK(observations.chain_result == 0);
+        CHECK(observations.step_results == std::vector<int32_t>{1, 2, 3});
+        CHECK(observations.steps_completed);
+        CHECK(observations.piped == "abcdef");
+        CHECK(observations.next_result == 0);
+    }
+
+    SECTION("Canceling the chain cancels the running head and the steps after it") {
+        run_root_task<HeadCancelTask>(ThreadConfig{}, std::ref(observations));
+
+        CHECK(observations.chain_result == -ECANCELED);
+        CHECK(observations.step_results == std::vector<int32_t>{-ECANCELED, -ECANCELED, -ECANCELED});
+        CHECK(observations.steps_completed);
+        CHECK(observations.piped.empty());
+        CHECK(observations.next_result == 0);
+    }
+
+    SECTION("A failed step cancels the steps after it") {
+        run_root_task<FailureTask>(ThreadConfig{}, std::ref(observations));
+
+        CHECK(observations.chain_result == -ECANCELED);
+        REQUIRE(observations.step_results.size() == 3);
+        CHECK(observations.step_results[0] == -EBADF);
+        CHECK(observations.step_results[1] == -ECANCELED);
+        CHECK(observations.step_results[2] == -ECANCELED);
+        CHECK(observations.steps_completed);
+        CHECK(observations.piped.empty());
+        CHECK(observations.next_result == 0);
+    }
+
+    SECTION("A chain that can't fit in the submission queue fails without running") {
+        constexpr size_t submission_queue_size = 8;
+
+        ThreadConfig config;
+        config.reactor.submission_queue_size = submission_queue_size;
+        run_root_task<OversizedTask>(config, submission_queue_size, std::ref(observations));
+
+        CHECK(observations.chain_result == -EINVAL);
+        CHECK(observations.step_results == std::vector<int32_t>(submission_queue_size, -ECANCELED));
+        CHECK(observations.steps_completed);
+        CHECK(observations.next_result == 0);
+    }
+}
@@ -0,0 +1,121 @@
+#include "catch.hpp"
+#include "ut_runtime.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+using namespace slag;
+using namespace std::chrono_literals;
+
+namespace {
+
+    struct ListenObservations {
+        bool    direct_supported = false;
+        size_t  accepted_count   = 0;
+        size_t  fixed_count      = 0;     // Accepted straight into a fixed file slot.
+        bool    overflowed       = false; // The completion queue overflowed, which ends multishot accepts.
+        int32_t error            = 0;
+        bool    timed_out        = false;
+    };
+
+    // Connects a burst of clients to a loopback listener before its accept is even submitted,
+    // so that the multishot accept fills the completion queue and the kernel ends it.
+    class ListenTask final : public ProtoTask {
+    public:
+        ListenTask(bool direct, size_t client_count, ListenObservations& observations)
+            : direct_(direct)
+            , client_count_(client_count)
+            , observations_(observations)
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            observations_.direct_supported = get_reactor().has_capability(Capability::DIRECT_ACCEPT);
+
+            {
+                struct sockaddr_in address;
+                memset(&address, 0, sizeof(address));
+                address.sin_family = AF_INET;
+                address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+                Ref<FileDescriptor> socket = make_file_descriptor(::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0));
+                socklen_t address_length = sizeof(address);
+                if (::bind(socket->borrow(), reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0 ||
+                    ::listen(socket->borrow(), static_cast<int>(client_count_)) < 0 ||
+                    ::getsockname(socket->borrow(), reinterpret_cast<struct sockaddr*>(&address), &address_length) < 0) {
+                    throw std::runtime_error("Failed to listen on loopback");
+                }
+
+                listener_.emplace(std::move(socket), direct_);
+
+                for (size_t index = 0; index < client_count_; ++index) {
+                    Ref<FileDescriptor> client = make_file_descriptor(::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0));
+                    if (::connect(client->borrow(), reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0) {
+                        throw std::runtime_error("Failed to connect");
+                    }
+                    clients_.push_back(std::move(client));
+                }
+            }
+
+            while (observations_.accepted_count < client_count_) {
+                // A readable event that was lost when the accept was rearmed would stall here.
+                SLAG_PT_WAIT_READABLE_FOR(*listener_, 5s);
+                if (pt_timed_out()) {
+                    observations_.timed_out = true;
+                    break;
+                }
+
+                while (Ptr<FileDescriptor> connection = listener_->accept()) {
+                    observations_.accepted_count += 1;
+                    observations_.fixed_count += (connection->borrow() < 0) && connection->is_fixed();
+                }
+
+                if (listener_->error()) {
+                    break;
+                }
+            }
+
+            observations_.overflowed = get_reactor().metrics().overflow_count > 0;
+            observations_.error = listener_->error();
+
+            SLAG_PT_END();
+        }
+
+    private:
+        bool                             direct_;
+        size_t                           client_count_;
+        ListenObservations&              observations_;
+        std::optional<Listener>          listener_;
+        std::vector<Ptr<FileDescriptor>> clients_;
+    };
+
+}
+
+TEST_CASE("Listener") {
+    const bool direct = GENERATE(false, true);
+
+    ListenObservations observations;
+
+    SECTION("Accepting continues after the kernel ends a multishot accept") {
+        constexpr size_t client_count = 64;
+
+        ThreadConfig config;
+        config.reactor.submission_queue_size = 4;
+        config.reactor.completion_queue_size = 8;
+        run_root_task<ListenTask>(config, direct, client_count, std::ref(observations));
+
+        CHECK(!observations.timed_out);
+        CHECK(observations.error == 0);
+        CHECK(observations.accepted_count == client_count);
+        CHECK(observations.overflowed);
+        CHECK(observations.fixed_count == ((direct && observations.direct_supported) ? client_count : 0));
+    }
+}
@@ -0,0 +1,53 @@
+#include "catch.hpp"
+#include "slag/slag.h"
+
+using namespace slag;
+
+TEST_CASE("WorkerSelector") {
+    Fabric         fabric;
+    WorkerSelector selector(fabric);
+
+    SECTION("No candidates") {
+        CHECK(!selector.select(0));
+    }
+
+    SECTION("Picks the least loaded candidate") {
+        fabric.thread_load(0).publish(5);
+        fabric.thread_load(1).publish(2);
+        fabric.thread_load(2).publish(1);
+
+        CHECK(selector.select(0b011) == 1);
+        CHECK(selector.select(0b111) == 2);
+    }
+
+    SECTION("Counts what was handed out until the load is published again") {
+        fabric.thread_load(0).publish(1);
+        fabric.thread_load(1).publish(3);
+
+        // Thread 0 is picked until what it was handed takes it past thread 1, with ties going
+        // to the lower index.
+        CHECK(selector.select(0b11) == 0);
+        CHECK(selector.select(0b11) == 0);
+        CHECK(selector.select(0b11) == 0);
+        CHECK(selector.select(0b11) == 1);
+
+        // Publishing the same load leaves the epoch, and so the counts, as they were.
+        fabric.thread_load(0).publish(1);
+        CHECK(selector.select(0b11) == 0);
+        CHECK(selector.select(0b11) == 1);
+
+        // A new load replaces what was counted for that thread, but not for the other one.
+        fabric.thread_load(0).publish(4);
+        CHECK(selector.select(0b11) == 0);
+        CHECK(selector.select(0b11) == 0);
+        CHECK(selector.select(0b11) == 1);
+    }
+
+    SECTION("Threads that are not candidates are left alone") {
+        fabric.thread_load(1).publish(4);
+
+        CHECK(selector.select(0b10) == 1);
+        CHECK(selector.select(0b10) == 1);
+        CHECK(selector.select(0b11) == 0);
+    }
+}
@@ -0,0 +1,464 @@
+#include "catch.hpp"
+#include "ut_runtime.h"
+
+#include <sys/socket.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+using namespace slag;
+using namespace std::chrono_literals;
+
+namespace {
+
+    size_t live_operation_count(Reactor& reactor, const OperationType operation_type) {
+        const SlabPool::Metrics* metrics = reactor.operation_pool_metrics(operation_type);
+        return metrics ? metrics->size : 0;
+    }
+
+    // Submits a timer, retires it, and submits another one in the block it leaves behind.
+    class KeyReuseTask final : public ProtoTask {
+    public:
+        struct Observations {
+            bool         reused_block       = false;
+            OperationKey first_key;
+            OperationKey second_key;
+            bool         accepts_stale_key  = true;
+            bool         accepts_second_key = false;
+        };
+
+        explicit KeyReuseTask(Observations& observations)
+            : observations_(observations)
+            , first_operation_(nullptr)
+        {
+        }
+
+        void run() override {
+            Reactor& reactor = get_reactor();
+
+            SLAG_PT_BEGIN();
+
+            timer_ = start_timer_operation(TimerOperation::Clock::now() + 1h);
+            first_operation_ = &*timer_;
+
+            reactor.poll(true);
+            observations_.first_key = timer_->key();
+
+            timer_->cancel();
+            SLAG_PT_WAIT_COMPLETE(*timer_);
+            timer_.reset();
+
+            // Wait for it to be finalized, and returned to its pool.
+            UT_PT_WAIT_UNTIL(live_operation_count(reactor, OperationType::TIMER) == 0);
+
+            timer_ = start_timer_operation(TimerOperation::Clock::now() + 1h);
+            observations_.reused_block = (&*timer_ == first_operation_);
+
+            reactor.poll(true);
+            observations_.second_key = timer_->key();
+
+            // A completion that still carries the first key must not be taken for this one.
+            observations_.accepts_stale_key = timer_->uses_key(observations_.first_key);
+            observations_.accepts_second_key = timer_->uses_key(observations_.second_key);
+
+            timer_->cancel();
+            SLAG_PT_WAIT_COMPLETE(*timer_);
+
+            SLAG_PT_END();
+        }
+
+    private:
+        Observations&         observations_;
+        Ptr<TimerOperation>   timer_;
+        const TimerOperation* first_operation_;
+    };
+
+
+    // Counts for one burst of operations, as seen by the root task.
+    struct BurstObservations {
+        size_t base_in_flight_count   = 0; // The drivers' own operations.
+        size_t submitted_count        = 0; // After the first poll.
+        size_t pending_count          = 0; // After the first poll.
+        size_t in_flight_count        = 0; // After the first poll.
+        bool   writable               = true; // After the first poll.
+        size_t completed_count        = 0;
+        size_t succeeded_count        = 0;
+        size_t poll_count             = 0;
+        size_t final_in_flight_count  = 0;
+        bool   final_writable         = false;
+        Reactor::Metrics metrics_before;
+        Reactor::Metrics metrics_after;
+    };
+
+    // Polls often enough for any burst in these tests to drain.
+    constexpr size_t MAX_POLL_COUNT = 1000;
+
+    // Starts a burst of operations from a single task run, so that the event loop doesn't
+    // poll the reactor in between, and drives the reactor by hand until they have all completed.
+    template<typename OperationImpl>
+    class BurstTask : public ProtoTask {
+    public:
+        BurstTask(size_t operation_count, BurstObservations& observations)
+            : operation_count_(operation_count)
+            , observations_(observations)
+        {
+        }
+
+        void run() override {
+            Reactor& reactor = get_reactor();
+
+            SLAG_PT_BEGIN();
+
+            // Let the drivers (which run at idle priority) start their own operations first.
+            SLAG_PT_SLEEP(10ms);
+
+            observations_.base_in_flight_count = reactor.in_flight_count();
+            observations_.metrics_before = reactor.metrics();
+
+            for (size_t index = 0; index < operation_count_; ++index) {
+                operations_.push_back(start());
+            }
+
+            reactor.poll(true);
+            observations_.poll_count = 1;
+            observations_.in_flight_count = reactor.in_flight_count();
+            observations_.writable = reactor.writable_event().is_set();
+            for (const Ptr<OperationImpl>& operation: operations_) {
+                if (operation->state() == OperationState::OPERATION_PENDING) {
+                    observations_.pending_count += 1;
+                }
+                else {
+                    observations_.submitted_count += 1;
+                }
+            }
+
+            finish();
+
+            while (!is_drained() && (observations_.poll_count < MAX_POLL_COUNT)) {
+                reactor.poll(true);
+                observations_.poll_count += 1;
+            }
+
+            for (const Ptr<OperationImpl>& operation: operations_) {
+                if (operation->is_complete()) {
+                    observations_.completed_count += 1;
+                    observations_.succeeded_count += (operation->result() >= 0);
+                }
+            }
+
+            observations_.final_in_flight_count = reactor.in_flight_count();
+            observations_.final_writable = reactor.writable_event().is_set();
+            observations_.metrics_after = reactor.metrics();
+
+            SLAG_PT_END();
+        }
+
+    protected:
+        virtual Ref<OperationImpl> start() = 0;
+
+        // Called after the first poll.
+        virtual void finish() {
+        }
+
+        bool is_drained() const {
+            return std::all_of(operations_.begin(), operations_.end(), [](const Ptr<OperationImpl>& operation) {
+                return operation->is_complete();
+            });
+        }
+
+    protected:
+        size_t                          operation_count_;
+        BurstObservations&              observations_;
+        std::vector<Ptr<OperationImpl>> operations_;
+    };
+
+    class NopBurstTask final : public BurstTask<NopOperation> {
+    public:
+        using BurstTask::BurstTask;
+
+    private:
+        Ref<NopOperation> start() override {
+            return start_nop_operation();
+        }
+    };
+
+    // Timers stay in flight until they are canceled, which happens after the first poll.
+    class TimerBurstTask final : public BurstTask<TimerOperation> {
+    public:
+        using BurstTask::BurstTask;
+
+    private:
+        Ref<TimerOperation> start() override {
+            return start_timer_operation(TimerOperation::Clock::now() + 1h);
+        }
+
+        void finish() override {
+            for (const Ptr<TimerOperation>& operation: operations_) {
+                operation->cancel();
+            }
+        }
+    };
+
+
+    struct RegistrationObservations {
+        bool                 fixed_files_supported = false;
+        std::vector<bool>    fixed;          // Each sender, after its write completed.
+        std::vector<int32_t> write_results;
+        size_t               received_count = 0;
+    };
+
+    // Writes a byte to each of several socket pairs, leaving registration to the reactor.
+    class RegistrationTask final : public ProtoTask {
+    public:
+        RegistrationTask(size_t socket_count, RegistrationObservations& observations)
+            : socket_count_(socket_count)
+            , observations_(observations)
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            observations_.fixed_files_supported = get_reactor().has_capability(Capability::FIXED_FILES);
+
+            for (size_t index = 0; index < socket_count_; ++index) {
+                int file_descriptors[2];
+                if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, file_descriptors) < 0) {
+                    throw std::runtime_error("Failed to create socket pair");
+                }
+                Ref<FileDescriptor> sender = make_file_descriptor(file_descriptors[0]);
+                receivers_.push_back(make_file_descriptor(file_descriptors[1]));
+
+                writes_.push_back(start_write_operation(sender, BufferSlice(bind(*new Buffer(1)))));
+                senders_.push_back(std::move(sender));
+            }
+
+            for (index_ = 0; index_ < writes_.size(); ++index_) {
+                SLAG_PT_WAIT_COMPLETE(*writes_[index_]);
+                observations_.fixed.push_back(senders_[index_]->is_fixed());
+                observations_.write_results.push_back(writes_[index_]->result());
+            }
+
+            for (const Ptr<FileDescriptor>& receiver: receivers_) {
+                std::byte payload;
+                if (recv(receiver->borrow(), &payload, sizeof(payload), MSG_DONTWAIT) == sizeof(payload)) {
+                    observations_.received_count += 1;
+                }
+            }
+
+            SLAG_PT_END();
+        }
+
+    private:
+        size_t                           socket_count_;
+        RegistrationObservations&        observations_;
+        std::vector<Ptr<FileDescriptor>> senders_;
+        std::vector<Ptr<FileDescriptor>> receivers_;
+        std::vector<Ptr<WriteOperation>> writes_;
+        size_t                           index_ = 0;
+    };
+
+    struct BatchObservations {
+        size_t  caller_datagram_count = 0; // Left in the caller's vector after starting the batch.
+        size_t  queued_count          = 0;
+        size_t  sent_count            = 0;
+        int32_t result                = -EAGAIN;
+        size_t  received_count        = 0;
+    };
+
+    // Sends more datagrams than fit in one batch over a socket pair.
+    class BatchTask final : public ProtoTask {
+    public:
+        BatchTask(size_t datagram_count, BatchObservations& observations)
+            : datagram_count_(datagram_count)
+            , observations_(observations)
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            {
+                int file_descriptors[2];
+                if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, file_descriptors) < 0) {
+                    throw std::runtime_error("Failed to create socket pair");
+                }
+                sender_ = make_file_descriptor(file_descriptors[0]);
+                receiver_ = make_file_descriptor(file_descriptors[1]);
+            }
+
+            for (size_t index = 0; index < datagram_count_; ++index) {
+                datagrams_.emplace_back(BufferSlice(bind(*new Buffer(1))));
+            }
+
+            batch_ = start_send_message_batch_operation(bind(*sender_), datagrams_);
+            observations_.caller_datagram_count = datagrams_.size();
+            observations_.queued_count = batch_->datagram_count();
+
+            SLAG_PT_WAIT_COMPLETE(*batch_);
+            observations_.sent_count = batch_->sent_count();
+            observations_.result = batch_->result();
+
+            {
+                std::byte payload;
+                while (recv(receiver_->borrow(), &payload, sizeof(payload), MSG_DONTWAIT) == sizeof(payload)) {
+                    observations_.received_count += 1;
+                }
+            }
+
+            SLAG_PT_END();
+        }
+
+    private:
+        size_t                         datagram_count_;
+        BatchObservations&             observations_;
+        Ptr<FileDescriptor>            sender_;
+        Ptr<FileDescriptor>            receiver_;
+        std::vector<Datagram>          datagrams_;
+        Ptr<SendMessageBatchOperation> batch_;
+    };
+
+}
+
+TEST_CASE("Operation keys") {
+    const OperationKeyEncoding encoding = GENERATE(OperationKeyEncoding::TABLE, OperationKeyEncoding::TAGGED_POINTER);
+
+    SECTION("Stale keys are rejected after an operation's block is reused") {
+        ThreadConfig config;
+        config.reactor.operation_key_encoding = encoding;
+
+        KeyReuseTask::Observations observations;
+        run_root_task<KeyReuseTask>(config, std::ref(observations));
+
+        CHECK(observations.reused_block);
+        REQUIRE(observations.first_key);
+        REQUIRE(observations.second_key);
+        CHECK(observations.first_key != observations.second_key);
+        CHECK(!observations.accepts_stale_key);
+        CHECK(observations.accepts_second_key);
+    }
+}
+
+TEST_CASE("Reactor admission") {
+    BurstObservations observations;
+
+    SECTION("New operations are held back at the in-flight limit, but cancels are not") {
+        constexpr size_t in_flight_limit = 8;
+        constexpr size_t timer_count = 12;
+
+        ThreadConfig config;
+        config.reactor.in_flight_limit = in_flight_limit;
+        run_root_task<TimerBurstTask>(config, timer_count, std::ref(observations));
+
+        REQUIRE(observations.base_in_flight_count < in_flight_limit);
+        CHECK(observations.in_flight_count == in_flight_limit);
+        CHECK(observations.submitted_count == in_flight_limit - observations.base_in_flight_count);
+        CHECK(observations.pending_count == timer_count - observations.submitted_count);
+        CHECK(!observations.writable);
+        CHECK(observations.metrics_after.throttle_count > observations.metrics_before.throttle_count);
+
+        // The submitted timers are canceled while the reactor is throttled.
+        CHECK(observations.completed_count == timer_count);
+        CHECK(observations.succeeded_count == 0);
+        CHECK(observations.final_in_flight_count == observations.base_in_flight_count);
+        CHECK(observations.final_writable);
+    }
+
+    SECTION("Bursts larger than the submission queue are submitted in one pass") {
+        constexpr size_t nop_count = 20;
+
+        ThreadConfig config;
+        config.reactor.submission_queue_size = 8;
+        config.reactor.completion_queue_size = 64;
+        run_root_task<NopBurstTask>(config, nop_count, std::ref(observations));
+
+        // The queue is handed to the kernel each time it fills up (after 8 and 16 entries).
+        CHECK(observations.pending_count == 0);
+        CHECK(observations.submitted_count == nop_count);
+        CHECK(observations.metrics_after.full_submission_count - observations.metrics_before.full_submission_count == 2);
+
+        CHECK(observations.completed_count == nop_count);
+        CHECK(observations.succeeded_count == nop_count);
+        CHECK(observations.metrics_after.completion_count - observations.metrics_before.completion_count >= nop_count);
+        CHECK(observations.final_in_flight_count == observations.base_in_flight_count);
+    }
+
+    SECTION("Admission stops while completions overflow, and resumes once they are reaped") {
+        constexpr size_t nop_count = 24;
+
+        ThreadConfig config;
+        config.reactor.submission_queue_size = 8;
+        config.reactor.completion_queue_size = 8;
+        config.reactor.in_flight_limit = 64; // Past the completion queue, so that it can overflow.
+        run_root_task<NopBurstTask>(config, nop_count, std::ref(observations));
+
+        CHECK(observations.submitted_count == nop_count);
+        CHECK(!observations.writable);
+        CHECK(observations.metrics_after.overflow_count > observations.metrics_before.overflow_count);
+
+        // Nothing was dropped.
+        CHECK(observations.poll_count > 1);
+        CHECK(observations.completed_count == nop_count);
+        CHECK(observations.succeeded_count == nop_count);
+        CHECK(observations.metrics_after.completion_count - observations.metrics_before.completion_count >= nop_count);
+        CHECK(observations.final_writable);
+
+        // The kernel ends multishot operations (the drivers' polls) that it can't post completions for.
+        CHECK(observations.final_in_flight_count <= observations.base_in_flight_count);
+    }
+}
+
+TEST_CASE("Datagram batches") {
+    constexpr size_t submission_queue_size = 8;
+    constexpr size_t datagram_count = 12;
+
+    ThreadConfig config;
+    config.reactor.submission_queue_size = submission_queue_size;
+    config.reactor.completion_queue_size = 64;
+
+    BatchObservations observations;
+    run_root_task<BatchTask>(config, datagram_count, std::ref(observations));
+
+    // One entry is left for a deadline, and the caller keeps every datagram to send the rest.
+    CHECK(observations.caller_datagram_count == datagram_count);
+    CHECK(observations.queued_count == submission_queue_size - 1);
+    CHECK(observations.sent_count == observations.queued_count);
+    CHECK(observations.result == 0);
+    CHECK(observations.received_count == observations.queued_count);
+}
+
+TEST_CASE("Fixed file registration") {
+    RegistrationObservations observations;
+
+    SECTION("Descriptors take a fixed slot when they are first submitted") {
+        run_root_task<RegistrationTask>(ThreadConfig{}, size_t{2}, std::ref(observations));
+
+        const bool fixed = observations.fixed_files_supported;
+        CHECK(observations.fixed == std::vector<bool>{fixed, fixed});
+        CHECK(observations.write_results == std::vector<int32_t>{1, 1});
+        CHECK(observations.received_count == 2);
+    }
+
+    SECTION("Descriptors fall back to plain descriptors once the table is full") {
+        ThreadConfig config;
+        config.reactor.fixed_file_table_size = 2; // The region driver registers its descriptor first.
+        run_root_task<RegistrationTask>(config, size_t{3}, std::ref(observations));
+
+        const bool fixed = observations.fixed_files_supported;
+        CHECK(observations.fixed == std::vector<bool>{fixed, false, false});
+        CHECK(observations.write_results == std::vector<int32_t>{1, 1, 1});
+        CHECK(observations.received_count == 3);
+    }
+
+    SECTION("Registration can be left to the caller") {
+        ThreadConfig config;
+        config.reactor.register_files_on_submit = false;
+        run_root_task<RegistrationTask>(config, size_t{2}, std::ref(observations));
+
+        CHECK(observations.fixed == std::vector<bool>{false, false});
+        CHECK(observations.write_results == std::vector<int32_t>{1, 1});
+        CHECK(observations.received_count == 2);
+    }
+}
@@ -0,0 +1,187 @@
+#include "catch.hpp"
+#include "ut_runtime.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <functional>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+using namespace slag;
+
+namespace {
+
+    constexpr std::string_view PAYLOAD = "hello";
+
+    enum class ReceiveMode {
+        MULTISHOT,
+        SINGLE_SHOT,
+        FACTORY, // Whatever the factory picks for this kernel.
+    };
+
+    struct ReceiveObservations {
+        bool        multishot_supported = false;
+        std::string received;
+        bool        has_source          = false; // Messages only: the sender's loopback port.
+        bool        complete            = false; // After the first receive.
+        int32_t     result              = 0;     // After the first receive.
+    };
+
+    std::string to_string(const std::span<const std::byte> bytes) {
+        return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+    }
+
+    Ref<FileDescriptor> make_loopback_socket(struct sockaddr_in& address) {
+        Ref<FileDescriptor> socket = make_file_descriptor(::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0));
+
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        socklen_t address_length = sizeof(address);
+        if (::bind(socket->borrow(), reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0 ||
+            ::getsockname(socket->borrow(), reinterpret_cast<struct sockaddr*>(&address), &address_length) < 0) {
+            throw std::runtime_error("Failed to bind loopback socket");
+        }
+
+        return socket;
+    }
+
+    // Receives one payload that is already waiting on the socket, and then stops the operation
+    // if it is still going.
+    template<typename OperationImpl>
+    class ReceiveTask final : public ProtoTask {
+    public:
+        ReceiveTask(ReceiveMode mode, ReceiveObservations& observations)
+            : mode_(mode)
+            , observations_(observations)
+        {
+        }
+
+        void run() override {
+            Reactor& reactor = get_reactor();
+
+            SLAG_PT_BEGIN();
+
+            observations_.multishot_supported = reactor.has_capability(Capability::MULTISHOT_RECV);
+
+            {
+                Ref<FileDescriptor> receiver = make_receiver();
+                if (::send(sender_->borrow(), PAYLOAD.data(), PAYLOAD.size(), 0) != static_cast<ssize_t>(PAYLOAD.size())) {
+                    throw std::runtime_error("Failed to send");
+                }
+
+                // Room for the header and source address that precede each multishot message.
+                BufferRing& buffer_ring = reactor.create_buffer_ring(4, 256);
+                operation_ = start(receiver, buffer_ring);
+            }
+
+            SLAG_PT_WAIT_READABLE(*operation_);
+            record();
+            observations_.complete = operation_->is_complete();
+            observations_.result = operation_->result();
+
+            operation_->cancel();
+            SLAG_PT_WAIT_COMPLETE(*operation_);
+
+            SLAG_PT_END();
+        }
+
+    private:
+        // Connects the sender to a stream socket pair, or to a datagram socket with an address.
+        Ref<FileDescriptor> make_receiver() {
+            if constexpr (std::is_same_v<OperationImpl, ReceiveMultishotOperation>) {
+                int file_descriptors[2];
+                if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, file_descriptors) < 0) {
+                    throw std::runtime_error("Failed to create socket pair");
+                }
+                sender_ = make_file_descriptor(file_descriptors[1]);
+                return make_file_descriptor(file_descriptors[0]);
+            }
+            else {
+                struct sockaddr_in receiver_address;
+                Ref<FileDescriptor> receiver = make_loopback_socket(receiver_address);
+                sender_ = make_loopback_socket(sender_address_);
+                if (::connect(sender_->borrow(), reinterpret_cast<struct sockaddr*>(&receiver_address), sizeof(receiver_address)) < 0) {
+                    throw std::runtime_error("Failed to connect");
+                }
+                return receiver;
+            }
+        }
+
+        Ref<OperationImpl> start(const Ref<FileDescriptor>& receiver, BufferRing& buffer_ring) {
+            if (mode_ == ReceiveMode::FACTORY) {
+                if constexpr (std::is_same_v<OperationImpl, ReceiveMultishotOperation>) {
+                    return start_receive_multishot_operation(receiver, buffer_ring);
+                }
+                else {
+                    return start_receive_message_multishot_operation(receiver, buffer_ring);
+                }
+            }
+
+            Reactor& reactor = get_reactor();
+
+            const bool multishot = mode_ == ReceiveMode::MULTISHOT;
+            auto op = reactor.create_operation<OperationImpl>(receiver, buffer_ring, multishot);
+            reactor.schedule_operation(*op);
+            return op;
+        }
+
+        void record() {
+            if constexpr (std::is_same_v<OperationImpl, ReceiveMultishotOperation>) {
+                while (std::optional<BufferSlice> slice = operation_->receive()) {
+                    observations_.received += to_string(slice->selection());
+                }
+            }
+            else {
+                while (std::optional<Datagram> datagram = operation_->receive()) {
+                    observations_.received += to_string(datagram->payload.selection());
+                    const auto& source = reinterpret_cast<const struct sockaddr_in&>(datagram->address);
+                    observations_.has_source = (datagram->address_length == sizeof(source)) &&
+                                               (source.sin_family == AF_INET) &&
+                                               (source.sin_port == sender_address_.sin_port);
+                }
+            }
+        }
+
+    private:
+        ReceiveMode          mode_;
+        ReceiveObservations& observations_;
+        Ptr<FileDescriptor>  sender_;
+        struct sockaddr_in   sender_address_ = {};
+        Ptr<OperationImpl>   operation_;
+    };
+
+    void check_receive(const ReceiveMode mode, const ReceiveObservations& observations) {
+        CHECK(observations.received == PAYLOAD);
+
+        // A single-shot receive stops after the first completion as if the kernel had ended
+        // multishot, so the caller starts another one to keep receiving.
+        const bool multishot = (mode == ReceiveMode::MULTISHOT) || ((mode == ReceiveMode::FACTORY) && observations.multishot_supported);
+        CHECK(observations.complete == !multishot);
+        CHECK(observations.result == -EAGAIN);
+    }
+
+}
+
+TEST_CASE("Receive multishot fallback") {
+    const ReceiveMode mode = GENERATE(ReceiveMode::MULTISHOT, ReceiveMode::SINGLE_SHOT, ReceiveMode::FACTORY);
+
+    ReceiveObservations observations;
+
+    SECTION("Stream receives") {
+        run_root_task<ReceiveTask<ReceiveMultishotOperation>>(ThreadConfig{}, mode, std::ref(observations));
+        check_receive(mode, observations);
+    }
+
+    SECTION("Message receives") {
+        run_root_task<ReceiveTask<ReceiveMessageMultishotOperation>>(ThreadConfig{}, mode, std::ref(observations));
+        check_receive(mode, observations);
+        CHECK(observations.has_source);
+    }
+}
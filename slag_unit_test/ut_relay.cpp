@@ -0,0 +1,294 @@
+#include "catch.hpp"
+#include "ut_runtime.h"
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace slag;
+using namespace std::chrono_literals;
+
+namespace {
+
+    constexpr std::string_view PAYLOAD = "payload";
+
+    // Distinguishable at every offset, so that reordered or repeated chunks are caught.
+    std::string make_data(const size_t size) {
+        std::string data(size, '\0');
+        for (size_t index = 0; index < size; ++index) {
+            data[index] = static_cast<char>('a' + ((index * 7 + index / 4096) % 26));
+        }
+        return data;
+    }
+
+    Ref<FileDescriptor> make_memory_file(const std::string& contents) {
+        Ref<FileDescriptor> file = make_file_descriptor(memfd_create("ut_relay", MFD_CLOEXEC));
+        if ((file->borrow() < 0) || (::write(file->borrow(), contents.data(), contents.size()) != static_cast<ssize_t>(contents.size()))) {
+            throw std::runtime_error("Failed to create memory file");
+        }
+        if (::lseek(file->borrow(), 0, SEEK_SET) < 0) {
+            throw std::runtime_error("Failed to rewind memory file");
+        }
+        return file;
+    }
+
+    std::string read_memory_file(const Ref<FileDescriptor>& file, const size_t size) {
+        std::string contents(size, '\0');
+        const ssize_t result = ::pread(file->borrow(), contents.data(), contents.size(), 0);
+        contents.resize(result > 0 ? static_cast<size_t>(result) : 0);
+        return contents;
+    }
+
+    std::string read_pipe(const Ref<FileDescriptor>& reader) {
+        char bytes[64];
+        const ssize_t result = ::read(reader->borrow(), bytes, sizeof(bytes));
+        return {bytes, result > 0 ? static_cast<size_t>(result) : 0};
+    }
+
+    struct PipeObservations {
+        int32_t     tee_result     = 0;
+        int32_t     splice_result  = 0;
+        std::string teed;
+        std::string spliced;
+        int32_t     empty_result   = -EAGAIN; // Splicing from an empty pipe that has no writers.
+
+        size_t      capacity       = 0;
+        bool        grown          = false;
+        size_t      grown_capacity = 0;
+        bool        shrunk         = true;    // Below the data in the pipe, which fails.
+        size_t      full_capacity  = 0;
+    };
+
+    class PipeTask final : public ProtoTask {
+    public:
+        explicit PipeTask(PipeObservations& observations)
+            : observations_(observations)
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            source_ = make_pipe();
+            copy_ = make_pipe();
+            sink_ = make_pipe();
+            if (::write(source_->writer()->borrow(), PAYLOAD.data(), PAYLOAD.size()) != static_cast<ssize_t>(PAYLOAD.size())) {
+                throw std::runtime_error("Failed to write");
+            }
+
+            // Tee leaves the bytes in the source for the splice.
+            tee_ = start_tee_operation(source_->reader(), copy_->writer(), 64);
+            SLAG_PT_WAIT_COMPLETE(*tee_);
+            observations_.tee_result = tee_->result();
+
+            splice_ = start_splice_operation(source_->reader(), sink_->writer(), 64);
+            SLAG_PT_WAIT_COMPLETE(*splice_);
+            observations_.splice_result = splice_->result();
+
+            observations_.teed = read_pipe(copy_->reader());
+            observations_.spliced = read_pipe(sink_->reader());
+
+            empty_ = make_pipe();
+            empty_->writer()->close();
+            splice_ = start_splice_operation(empty_->reader(), sink_->writer(), 64);
+            SLAG_PT_WAIT_COMPLETE(*splice_);
+            observations_.empty_result = splice_->result();
+
+            observations_.capacity = sink_->capacity();
+            observations_.grown = sink_->resize(sink_->capacity() * 2);
+            observations_.grown_capacity = sink_->capacity();
+            {
+                const std::string data = make_data(observations_.grown_capacity);
+                if (::write(sink_->writer()->borrow(), data.data(), data.size()) != static_cast<ssize_t>(data.size())) {
+                    throw std::runtime_error("Failed to fill");
+                }
+            }
+            observations_.shrunk = sink_->resize(4096);
+            observations_.full_capacity = sink_->capacity();
+
+            SLAG_PT_END();
+        }
+
+    private:
+        PipeObservations&    observations_;
+        Ptr<Pipe>            source_;
+        Ptr<Pipe>            copy_;
+        Ptr<Pipe>            sink_;
+        Ptr<Pipe>            empty_;
+        Ptr<TeeOperation>    tee_;
+        Ptr<SpliceOperation> splice_;
+    };
+
+    struct RelayObservations {
+        uint64_t    relayed_byte_count = 0;
+        int32_t     error              = -EAGAIN;
+        size_t      pipe_capacity      = 0;
+        size_t      initial_capacity   = 0; // Of a new pipe.
+        std::string received;
+        bool        timed_out          = false;
+    };
+
+    // Relays a file into another one. Both ends always keep up, so the pipe is grown.
+    class FileRelayTask final : public ProtoTask {
+    public:
+        FileRelayTask(const std::string& data, RelayObservations& observations)
+            : data_(data)
+            , observations_(observations)
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            observations_.initial_capacity = make_pipe()->capacity();
+
+            sink_ = make_memory_file(std::string{});
+            relay_.emplace(make_memory_file(data_), bind(*sink_));
+            SLAG_PT_WAIT_COMPLETE(*relay_);
+
+            observations_.relayed_byte_count = relay_->relayed_byte_count();
+            observations_.error = relay_->error();
+            observations_.pipe_capacity = relay_->pipe_capacity();
+            observations_.received = read_memory_file(bind(*sink_), data_.size() + 1);
+
+            SLAG_PT_END();
+        }
+
+    private:
+        const std::string&   data_;
+        RelayObservations&   observations_;
+        Ptr<FileDescriptor>  sink_;
+        std::optional<Relay> relay_;
+    };
+
+    // Relays between sockets. The source is shut down before anything is read from the
+    // sink, so the relay sees EOF while it still has data in its pipe for a backed up sink.
+    class SocketRelayTask final : public ProtoTask {
+    public:
+        SocketRelayTask(const std::string& data, RelayObservations& observations)
+            : data_(data)
+            , observations_(observations)
+            , attempt_count_(0)
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            {
+                const std::array<Ref<FileDescriptor>, 2> source = make_socket_pair();
+                if (::send(source[1]->borrow(), data_.data(), data_.size(), 0) != static_cast<ssize_t>(data_.size())) {
+                    throw std::runtime_error("Failed to send");
+                }
+                ::shutdown(source[1]->borrow(), SHUT_WR);
+
+                const std::array<Ref<FileDescriptor>, 2> sink = make_socket_pair();
+                const int buffer_size = 4096;
+                ::setsockopt(sink[0]->borrow(), SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+                sink_ = sink[1];
+
+                relay_.emplace(source[0], sink[0]);
+            }
+
+            SLAG_PT_SLEEP(50ms);
+
+            for (attempt_count_ = 0; (observations_.received.size() < data_.size()) && (attempt_count_ < 5000); ++attempt_count_) {
+                receive();
+                SLAG_PT_SLEEP(1ms);
+            }
+            observations_.timed_out = observations_.received.size() < data_.size();
+
+            SLAG_PT_WAIT_COMPLETE(*relay_);
+            receive(); // Anything past what was sent.
+
+            observations_.relayed_byte_count = relay_->relayed_byte_count();
+            observations_.error = relay_->error();
+
+            SLAG_PT_END();
+        }
+
+    private:
+        static std::array<Ref<FileDescriptor>, 2> make_socket_pair() {
+            int file_descriptors[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, file_descriptors) < 0) {
+                throw std::runtime_error("Failed to create socket pair");
+            }
+
+            return {make_file_descriptor(file_descriptors[0]), make_file_descriptor(file_descriptors[1])};
+        }
+
+        void receive() {
+            char bytes[16 * 1024];
+            ssize_t result;
+            while ((result = ::recv(sink_->borrow(), bytes, sizeof(bytes), MSG_DONTWAIT)) > 0) {
+                observations_.received.append(bytes, static_cast<size_t>(result));
+            }
+        }
+
+    private:
+        const std::string&   data_;
+        RelayObservations&   observations_;
+        Ptr<FileDescriptor>  sink_;
+        std::optional<Relay> relay_;
+        size_t               attempt_count_;
+    };
+
+}
+
+TEST_CASE("Pipe") {
+    SECTION("Tee duplicates what splice then moves") {
+        PipeObservations observations;
+        run_root_task<PipeTask>(ThreadConfig{}, std::ref(observations));
+
+        CHECK(observations.tee_result == static_cast<int32_t>(PAYLOAD.size()));
+        CHECK(observations.splice_result == static_cast<int32_t>(PAYLOAD.size()));
+        CHECK(observations.teed == PAYLOAD);
+        CHECK(observations.spliced == PAYLOAD);
+        CHECK(observations.empty_result == 0);
+    }
+
+    SECTION("Resizing") {
+        PipeObservations observations;
+        run_root_task<PipeTask>(ThreadConfig{}, std::ref(observations));
+
+        CHECK(observations.grown);
+        CHECK(observations.grown_capacity >= observations.capacity * 2);
+
+        // It can't shrink below the data it holds.
+        CHECK(!observations.shrunk);
+        CHECK(observations.full_capacity == observations.grown_capacity);
+    }
+}
+
+TEST_CASE("Relay") {
+    RelayObservations observations;
+
+    SECTION("The pipe grows while both ends keep up") {
+        const std::string data = make_data(4 * 1024 * 1024);
+        run_root_task<FileRelayTask>(ThreadConfig{}, std::cref(data), std::ref(observations));
+
+        CHECK(observations.error == 0);
+        CHECK(observations.relayed_byte_count == data.size());
+        CHECK(observations.received == data);
+        CHECK(observations.pipe_capacity > observations.initial_capacity);
+        CHECK(observations.pipe_capacity <= Relay::MAX_PIPE_CAPACITY);
+    }
+
+    SECTION("Data still in the pipe at EOF is relayed to a backed up sink") {
+        const std::string data = make_data(64 * 1024);
+        run_root_task<SocketRelayTask>(ThreadConfig{}, std::cref(data), std::ref(observations));
+
+        CHECK(!observations.timed_out);
+        CHECK(observations.error == 0);
+        CHECK(observations.relayed_byte_count == data.size());
+        CHECK(observations.received == data);
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <utility>
+#include "slag/slag.h"
+
+namespace slag {
+
+    // Runs the task as the root task of its own thread, and returns once it has completed.
+    // Tasks record what they observe, and the test checks it afterwards on its own thread.
+    template<typename RootTask, typename... Args>
+    void run_root_task(const ThreadConfig& config, Args&&... args) {
+        Runtime runtime;
+        runtime.spawn_thread<RootTask>(config, std::forward<Args>(args)...);
+    }
+
+}
+
+// Yields until the condition holds, so that the event loop can make progress in between.
+#define UT_PT_WAIT_UNTIL(condition) \
+    while (!(condition)) {          \
+        SLAG_PT_YIELD();            \
+    }
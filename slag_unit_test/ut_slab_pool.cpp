@@ -0,0 +1,64 @@
+#include "catch.hpp"
+#include "slag/slag.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace slag;
+
+TEST_CASE("SlabPool") {
+    constexpr size_t blocks_per_slab = 4;
+    SlabPool pool(24, 16, blocks_per_slab);
+
+    SECTION("Block geometry") {
+        CHECK(pool.block_size() == 32);
+        CHECK(pool.block_alignment() == 16);
+        CHECK(pool.metrics().slab_count == 0);
+    }
+
+    SECTION("Blocks are aligned and distinct") {
+        std::vector<void*> blocks;
+        for (size_t i = 0; i < 3 * blocks_per_slab; ++i) {
+            void* block = pool.allocate();
+            CHECK((reinterpret_cast<uintptr_t>(block) % 16) == 0);
+            blocks.push_back(block);
+        }
+
+        std::sort(blocks.begin(), blocks.end());
+        CHECK(std::adjacent_find(blocks.begin(), blocks.end()) == blocks.end());
+
+        const SlabPool::Metrics& metrics = pool.metrics();
+        CHECK(metrics.slab_count == 3);
+        CHECK(metrics.capacity == 3 * blocks_per_slab);
+        CHECK(metrics.size == 3 * blocks_per_slab);
+
+        for (void* block: blocks) {
+            pool.deallocate(block);
+        }
+
+        CHECK(metrics.size == 0);
+        CHECK(metrics.high_water_mark == 3 * blocks_per_slab);
+    }
+
+    SECTION("Freed blocks are reused") {
+        void* block = pool.allocate();
+        pool.deallocate(block);
+        CHECK(pool.allocate() == block);
+
+        const SlabPool::Metrics& metrics = pool.metrics();
+        CHECK(metrics.allocate_count == 2);
+        CHECK(metrics.deallocate_count == 1);
+        CHECK(metrics.slab_count == 1);
+    }
+
+    SECTION("Tags survive reuse") {
+        uint64_t tag = 1;
+        void* block = pool.allocate(tag);
+        CHECK(tag == 0);
+
+        pool.deallocate(block, 7);
+        CHECK(pool.allocate(tag) == block);
+        CHECK(tag == 7);
+    }
+}
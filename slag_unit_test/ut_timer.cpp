@@ -0,0 +1,148 @@
+#include "catch.hpp"
+#include "ut_runtime.h"
+
+#include <chrono>
+#include <functional>
+#include <optional>
+
+using namespace slag;
+using namespace std::chrono_literals;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct TimerObservations {
+        int32_t          expired_result  = 0;
+        int32_t          canceled_result = 0;
+        bool             timed_out       = false;
+        Clock::duration  elapsed         = {};
+    };
+
+    // Waits on a timer operation until it expires, and cancels another one.
+    class TimerOperationTask final : public ProtoTask {
+    public:
+        explicit TimerOperationTask(TimerObservations& observations)
+            : observations_(observations)
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            start_ = Clock::now();
+            timer_ = start_timer_operation(start_ + 20ms);
+            SLAG_PT_WAIT_COMPLETE(*timer_);
+            observations_.elapsed = Clock::now() - start_;
+            observations_.expired_result = timer_->result();
+
+            timer_ = start_timer_operation(Clock::now() + 1h);
+            SLAG_PT_YIELD();
+            timer_->cancel();
+            SLAG_PT_WAIT_COMPLETE(*timer_);
+            observations_.canceled_result = timer_->result();
+
+            SLAG_PT_END();
+        }
+
+    private:
+        TimerObservations&  observations_;
+        Clock::time_point   start_;
+        Ptr<TimerOperation> timer_;
+    };
+
+    // Waits on a channel that nothing is sent to.
+    class TimeoutTask final : public ProtoTask {
+    public:
+        explicit TimeoutTask(TimerObservations& observations)
+            : observations_(observations)
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            start_ = Clock::now();
+            SLAG_PT_WAIT_READABLE_FOR(channel_, 50ms);
+            observations_.timed_out = pt_timed_out();
+            observations_.elapsed = Clock::now() - start_;
+
+            SLAG_PT_END();
+        }
+
+    private:
+        TimerObservations& observations_;
+        Channel            channel_;
+        Clock::time_point  start_;
+    };
+
+    // Sleeps briefly, after the thread has already armed a much later timeout.
+    class SleeperTask final : public ProtoTask {
+    public:
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            SLAG_PT_YIELD();
+            SLAG_PT_YIELD();
+            SLAG_PT_SLEEP(20ms);
+
+            SLAG_PT_END();
+        }
+    };
+
+    // Waits for the sleeper with a long timeout. The thread blocks in the reactor meanwhile,
+    // so the sleeper only wakes it in time if the kernel timeout is moved earlier.
+    class WokenTask final : public ProtoTask {
+    public:
+        explicit WokenTask(TimerObservations& observations)
+            : observations_(observations)
+        {
+        }
+
+        void run() override {
+            SLAG_PT_BEGIN();
+
+            start_ = Clock::now();
+            sleeper_.emplace();
+            SLAG_PT_WAIT_COMPLETE_FOR(*sleeper_, 5s);
+            observations_.timed_out = pt_timed_out();
+            observations_.elapsed = Clock::now() - start_;
+
+            SLAG_PT_END();
+        }
+
+    private:
+        TimerObservations&         observations_;
+        std::optional<SleeperTask> sleeper_;
+        Clock::time_point          start_;
+    };
+
+}
+
+TEST_CASE("Timer") {
+    TimerObservations observations;
+
+    SECTION("Timer operations expire at their deadline, or are canceled") {
+        run_root_task<TimerOperationTask>(ThreadConfig{}, std::ref(observations));
+
+        CHECK(observations.expired_result == -ETIME);
+        CHECK(observations.elapsed >= 20ms);
+        CHECK(observations.canceled_result == -ECANCELED);
+    }
+
+    SECTION("A timed wait times out") {
+        run_root_task<TimeoutTask>(ThreadConfig{}, std::ref(observations));
+
+        CHECK(observations.timed_out);
+        CHECK(observations.elapsed >= 50ms);
+        CHECK(observations.elapsed < 1s);
+    }
+
+    SECTION("A timed wait is woken before it times out") {
+        run_root_task<WokenTask>(ThreadConfig{}, std::ref(observations));
+
+        CHECK(!observations.timed_out);
+        CHECK(observations.elapsed >= 20ms);
+        CHECK(observations.elapsed < 1s);
+    }
+}
@@ -0,0 +1,118 @@
+#include "catch.hpp"
+#include "slag/slag.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <memory>
+
+using namespace slag;
+using namespace std::chrono_literals;
+
+TEST_CASE("TimerWheel") {
+    const TimerWheel::TimePoint epoch{};
+    TimerWheel wheel(epoch);
+
+    SECTION("Empty wheel") {
+        CHECK(wheel.is_empty());
+        CHECK(!wheel.next_expiration());
+        CHECK(wheel.advance(epoch + 1h) == 0);
+    }
+
+    SECTION("Expired deadline") {
+        wheel.advance(epoch + 10ms);
+
+        Timer timer(wheel);
+        timer.set(epoch + 5ms);
+        CHECK(timer.is_expired());
+        CHECK(!timer.is_armed());
+        CHECK(wheel.is_empty());
+    }
+
+    SECTION("Single timer") {
+        Timer timer(wheel);
+        timer.set(epoch + 10ms);
+        CHECK(timer.is_armed());
+        CHECK(wheel.size() == 1);
+        CHECK(wheel.is_readable());
+
+        CHECK(wheel.next_expiration() == epoch + 10ms);
+        CHECK(!wheel.is_readable());
+
+        CHECK(wheel.advance(epoch + 9ms) == 0);
+        CHECK(!timer.is_expired());
+        CHECK(wheel.advance(epoch + 10ms) == 1);
+        CHECK(timer.is_expired());
+        CHECK(wheel.is_empty());
+    }
+
+    SECTION("Deadlines are rounded up to the next tick") {
+        Timer timer(wheel);
+        timer.set(epoch + 1500us);
+
+        wheel.advance(epoch + 1ms);
+        CHECK(!timer.is_expired());
+        wheel.advance(epoch + 2ms);
+        CHECK(timer.is_expired());
+    }
+
+    SECTION("Earlier timers make the wheel readable") {
+        Timer later(wheel);
+        Timer earlier(wheel);
+
+        later.set(epoch + 100ms);
+        CHECK(wheel.next_expiration());
+        CHECK(!wheel.is_readable());
+
+        earlier.set(epoch + 200ms);
+        CHECK(!wheel.is_readable());
+
+        earlier.set(epoch + 50ms);
+        CHECK(wheel.is_readable());
+    }
+
+    SECTION("Reset") {
+        Timer timer(wheel);
+        timer.set(epoch + 100ms);
+        timer.reset();
+        CHECK(!timer.is_armed());
+        CHECK(wheel.is_empty());
+        CHECK(wheel.advance(epoch + 200ms) == 0);
+        CHECK(!timer.is_expired());
+    }
+
+    SECTION("Cascading") {
+        // Spread timers over every level (and beyond the last one).
+        std::mt19937_64 generator(42);
+        std::uniform_int_distribution<uint64_t> distribution(1, 1ull << 26);
+
+        std::vector<std::unique_ptr<Timer>> timers;
+        std::vector<TimerWheel::TimePoint> deadlines;
+        for (size_t i = 0; i < 1000; ++i) {
+            auto&& deadline = deadlines.emplace_back(epoch + std::chrono::milliseconds(distribution(generator)));
+            auto&& timer = timers.emplace_back(std::make_unique<Timer>(wheel));
+            timer->set(deadline);
+        }
+
+        // Jump from expiration to expiration. Timers must expire exactly when their deadline is reached.
+        size_t expired_count = 0;
+        bool on_time = true;
+        while (std::optional<TimerWheel::TimePoint> expiration = wheel.next_expiration()) {
+            for (size_t i = 0; i < timers.size(); ++i) {
+                on_time &= timers[i]->is_expired() || (*expiration <= deadlines[i]);
+            }
+
+            expired_count += wheel.advance(*expiration);
+
+            for (size_t i = 0; i < timers.size(); ++i) {
+                on_time &= (timers[i]->is_expired() == (deadlines[i] <= *expiration));
+            }
+        }
+
+        CHECK(on_time);
+        CHECK(expired_count == timers.size());
+        for (const std::unique_ptr<Timer>& timer: timers) {
+            CHECK(timer->is_expired());
+        }
+    }
+}
@@ -24,17 +24,16 @@ public:
                 std::cout << (int)get_thread().index() << " sending message" << std::endl;
                 channel_.send(*target_, bind(new Message));
 
-                timer_.set(std::chrono::milliseconds(1000));
-                looping_ = true;
-                while (looping_) {
-                    if (timer_.is_expired()) {
-                        looping_ = false;
+                // Receive until the channel has been idle for a second.
+                while (true) {
+                    SLAG_PT_WAIT_READABLE_FOR(channel_, std::chrono::milliseconds(1000));
+                    if (pt_timed_out()) {
+                        break;
                     }
-                    if (Ptr<Message> message = channel_.receive()) {
+
+                    while (Ptr<Message> message = channel_.receive()) {
                         std::cout << get_thread().index() << " received message" << std::endl;
                     }
-
-                    SLAG_PT_YIELD();
                 }
             }
 
@@ -49,8 +48,6 @@ public:
 private:
     Channel channel_;
     std::optional<ChannelId> target_;
-    BasicTimer timer_;
-    bool looping_ = false;
 };
 
 int main(int argc, char** argv) {
@@ -7,6 +7,7 @@
 #include "slag/topology.h"
 #include "slag/collections/spsc_queue.h"
 
+#include <atomic>
 #include <optional>
 #include <string>
 #include <map>
@@ -42,6 +43,9 @@ namespace slag {
         {
         }
 
+        // Messages are subclassed to carry a payload, and deleted through the base class.
+        virtual ~Resource() = default;
+
         ChannelId origin() const {
             return origin_;
         }
@@ -49,6 +53,12 @@ namespace slag {
     private:
         friend class Router;
 
+        // Called on the destination thread when the message arrives, even if its channel is gone.
+        // Messages that carry resources of that thread take ownership of them here, since the
+        // message itself is finalized back on its origin thread.
+        virtual void handle_delivery() {
+        }
+
         bool bind(ChannelId origin) {
             if (origin_.valid) {
                 return false; // Already bound.
@@ -83,8 +93,84 @@ namespace slag {
         SpscQueue<Packet> queue_;
     };
 
+    // Shared by the threads that send to a thread, so that they only interrupt it when it may be
+    // blocked in the reactor and nobody else has already done so.
+    class alignas(64) Doorbell {
+    public:
+        // Returns true if the caller has to interrupt the owner.
+        bool ring(ThreadIndex source) {
+            if (pending_sources_.fetch_or(1ull << source, std::memory_order_seq_cst)) {
+                return false; // Whoever rang it first made sure the owner will look.
+            }
+
+            return !awake_.load(std::memory_order_seq_cst);
+        }
+
+        // Called by the owner before blocking. Returns false if it was rung in the meantime.
+        bool sleep() {
+            awake_.store(false, std::memory_order_seq_cst);
+            if (pending_sources_.load(std::memory_order_seq_cst)) {
+                awake_.store(true, std::memory_order_relaxed);
+                return false;
+            }
+
+            return true;
+        }
+
+        // Called by the owner after waking. Returns the threads that rang it since it last looked.
+        ThreadMask wake() {
+            awake_.store(true, std::memory_order_relaxed);
+            if (!pending_sources_.load(std::memory_order_relaxed)) {
+                return 0;
+            }
+
+            return pending_sources_.exchange(0, std::memory_order_acq_rel);
+        }
+
+    private:
+        std::atomic<bool>       awake_{true};
+        std::atomic<ThreadMask> pending_sources_{0};
+    };
+
+    // Published by each thread's event loop, so that work can be steered to the least loaded one.
+    // The epoch advances with each change, which tells readers their view is current.
+    class alignas(64) ThreadLoad {
+    public:
+        // Only called by the owner.
+        void publish(uint32_t load) {
+            if (load_.load(std::memory_order_relaxed) != load) {
+                load_.store(load, std::memory_order_relaxed);
+                epoch_.store(epoch_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+        }
+
+        uint32_t load() const {
+            return load_.load(std::memory_order_relaxed);
+        }
+
+        uint32_t epoch() const {
+            return epoch_.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::atomic<uint32_t> load_{0};
+        std::atomic<uint32_t> epoch_{0};
+    };
+
     class Fabric {
     public:
+        Doorbell& doorbell(ThreadIndex thread_index) {
+            assert(thread_index < MAX_THREAD_COUNT);
+
+            return doorbells_[thread_index];
+        }
+
+        ThreadLoad& thread_load(ThreadIndex thread_index) {
+            assert(thread_index < MAX_THREAD_COUNT);
+
+            return thread_loads_[thread_index];
+        }
+
         // Links between threads are created dynamically on first-use.
         Link& link(ThreadIndex src_thread, ThreadIndex dst_thread) {
             std::scoped_lock lock(mutex_);
@@ -125,9 +211,11 @@ namespace slag {
         using LinkTable = std::map<std::pair<ThreadIndex, ThreadIndex>, Link>;
         using ChannelTable = std::unordered_map<std::string, ChannelId>;
 
-        mutable std::mutex mutex_;
-        LinkTable          link_table_;
-        ChannelTable       channel_table_;
+        mutable std::mutex                       mutex_;
+        LinkTable                                link_table_;
+        ChannelTable                             channel_table_;
+        std::array<Doorbell, MAX_THREAD_COUNT>   doorbells_;
+        std::array<ThreadLoad, MAX_THREAD_COUNT> thread_loads_;
     };
 
     class Router final
@@ -135,6 +223,21 @@ namespace slag {
         , public Pollable<PollableType::WRITABLE> // Flush while set.
     {
     public:
+        struct Metrics {
+            size_t deliver_count = 0;
+            size_t route_count = 0;
+            size_t forward_count = 0;
+            size_t forward_success_count = 0;
+            size_t forward_failure_count = 0;
+            size_t send_count = 0;
+            size_t receive_count = 0;
+            size_t originate_count = 0;
+            size_t interrupt_count = 0;
+            size_t coalesced_interrupt_count = 0;
+            size_t interrupt_retry_count = 0;
+            size_t finalize_count = 0;
+        };
+
         Router(std::shared_ptr<Fabric> fabric, ThreadIndex thread_index);
 
         virtual ~Router() = default;
@@ -142,6 +245,8 @@ namespace slag {
         Event& readable_event() override;
         Event& writable_event() override;
 
+        Fabric& fabric();
+
         void attach(Channel& channel);
         void detach(Channel& channel);
 
@@ -154,14 +259,33 @@ namespace slag {
 
         void flush();
 
+        // Set when an interrupt this router sent has completed. Failed ones are retried by `reap_interrupts`.
+        Event& interrupt_event();
+        void reap_interrupts();
+
+        // The interrupt that is reused for a thread, once one has been sent to it.
+        Ptr<InterruptOperation> interrupt_operation(ThreadIndex tidx) const;
+
+        // Other threads only interrupt this one while it may be blocked. Returns false if one
+        // of them sent something in the meantime, in which case it shouldn't block.
+        bool sleep();
+
+        // Picks up links that were written to without an interrupt.
+        void wake();
+
         // TODO: create_message/destroy_message API to match the reactor.
         void finalize(Message& message);
 
+        const Metrics& metrics() const;
+
     private:
         void route(const Packet& packet);
         void deliver(const Packet& packet);
         bool forward(const Packet& packet);
 
+        void interrupt(ThreadIndex tidx);
+        static bool is_transient_error(int32_t result);
+
         void update_readiness();
 
     private:
@@ -194,21 +318,9 @@ namespace slag {
         PacketQueue& get_tx_backlog(ThreadIndex tidx);
 
     private:
-        struct Metrics {
-            size_t deliver_count = 0;
-            size_t route_count = 0;
-            size_t forward_count = 0;
-            size_t forward_success_count = 0;
-            size_t forward_failure_count = 0;
-            size_t send_count = 0;
-            size_t receive_count = 0;
-            size_t originate_count = 0;
-            size_t interrupt_count = 0;
-            size_t finalize_count = 0;
-        };
-
         std::shared_ptr<Fabric>                fabric_;
         ThreadIndex                            thread_index_;
+        Doorbell&                              doorbell_;
 
         std::vector<ChannelState>              channel_states_;
         std::vector<uint32_t>                  unused_channel_states_;
@@ -223,6 +335,13 @@ namespace slag {
         std::vector<PacketQueue>               tx_backlogs_;
         ThreadMask                             tx_backlog_mask_;
 
+        // One reusable interrupt per destination. A thread is in the retry mask if it has to be
+        // interrupted again once its last one completes.
+        std::vector<Ptr<InterruptOperation>>   tx_interrupts_;
+        ThreadMask                             tx_interrupt_mask_;
+        ThreadMask                             tx_interrupt_retry_mask_;
+        Selector                               tx_interrupt_selector_;
+
         Metrics                                metrics_;
     };
 
@@ -7,9 +7,12 @@ namespace slag {
     Router::Router(std::shared_ptr<Fabric> fabric, ThreadIndex thread_index)
         : fabric_(fabric)
         , thread_index_(thread_index)
+        , doorbell_(fabric_->doorbell(thread_index))
         , rx_event_(get_reactor().interrupt_state(InterruptReason::LINK).event)
         , rx_event_mask_(get_reactor().interrupt_state(InterruptReason::LINK).sources)
         , tx_event_mask_(0)
+        , tx_interrupt_mask_(0)
+        , tx_interrupt_retry_mask_(0)
     {
         assert(fabric_);
 
@@ -25,6 +28,10 @@ namespace slag {
         return rx_event_;
     }
 
+    Fabric& Router::fabric() {
+        return *fabric_;
+    }
+
     void Router::attach(Channel& channel) {
         ChannelState* state = nullptr;
         size_t channel_index = 0;
@@ -131,13 +138,16 @@ namespace slag {
         for_each_thread(rx_event_mask_, [&](const ThreadIndex rx_tidx) {
             Packet* packets[64];
 
-            if (const size_t packet_count = get_rx_link(rx_tidx).poll(packets)) {
+            SpscQueueConsumer<Packet>& rx_link = get_rx_link(rx_tidx);
+            if (const size_t packet_count = rx_link.poll(packets)) {
                 for (size_t packet_index = 0; packet_index < packet_count; ++packet_index) {
                     const Packet* packet = packets[packet_index];
                     assert(packet);
                     deliver(*packet);
                 }
 
+                // Polling again would yield the same packets until they are removed.
+                rx_link.remove(packet_count);
                 total_packet_count += packet_count;
             }
             else {
@@ -173,16 +183,12 @@ namespace slag {
             // Ensure all writes are visible.
             get_tx_link(tx_tidx).flush();
 
-            // FIXME: We should probably check the result of this and retry to avoid deadlocking.
-            start_interrupt_operation(
-                get_runtime().reactor(tx_tidx),
-                Interrupt {
-                    .source = thread_index_,
-                    .reason = InterruptReason::LINK,
-                }
-            )->daemonize();
-
-            metrics_.interrupt_count += 1;
+            if (fabric_->doorbell(tx_tidx).ring(thread_index_)) {
+                interrupt(tx_tidx);
+            }
+            else {
+                metrics_.coalesced_interrupt_count += 1;
+            }
         });
 
         tx_event_mask_ = 0;
@@ -190,6 +196,56 @@ namespace slag {
         update_readiness();
     }
 
+    Event& Router::interrupt_event() {
+        return tx_interrupt_selector_.readable_event();
+    }
+
+    void Router::reap_interrupts() {
+        // The selector only tells us that something completed, and the mask says what.
+        while (tx_interrupt_selector_.select()) {
+        }
+
+        for_each_thread(tx_interrupt_mask_, [&](const ThreadIndex tx_tidx) {
+            InterruptOperation& operation = *tx_interrupts_[tx_tidx];
+            if (!operation.is_complete()) {
+                return;
+            }
+
+            const ThreadMask tx_tmask = 1ull << tx_tidx;
+            tx_interrupt_mask_ &= ~tx_tmask;
+
+            // A lost interrupt could leave the receiver asleep with packets on the link, since
+            // the doorbell stays rung until it looks.
+            const bool failed = is_transient_error(operation.result());
+            if (failed) {
+                metrics_.interrupt_retry_count += 1;
+            }
+            if (failed || (tx_interrupt_retry_mask_ & tx_tmask)) {
+                tx_interrupt_retry_mask_ &= ~tx_tmask;
+                interrupt(tx_tidx);
+            }
+        });
+    }
+
+    Ptr<InterruptOperation> Router::interrupt_operation(const ThreadIndex tidx) const {
+        if (tidx < tx_interrupts_.size()) {
+            return tx_interrupts_[tidx];
+        }
+
+        return {};
+    }
+
+    bool Router::sleep() {
+        return doorbell_.sleep();
+    }
+
+    void Router::wake() {
+        if (const ThreadMask sources = doorbell_.wake()) {
+            rx_event_mask_ |= sources;
+            rx_event_.set();
+        }
+    }
+
     void Router::finalize(Message& message) {
         assert(!message.origin().valid || (message.origin().thread_index == thread_index_));
 
@@ -207,6 +263,10 @@ namespace slag {
         metrics_.finalize_count += 1;
     }
 
+    auto Router::metrics() const -> const Metrics& {
+        return metrics_;
+    }
+
     void Router::route(const Packet& packet) {
         if (thread_index_ == packet.dst_chid.thread_index) {
             deliver(packet);
@@ -231,6 +291,8 @@ namespace slag {
     void Router::deliver(const Packet& packet) {
         assert(thread_index_ == packet.dst_chid.thread_index);
 
+        packet.msg->handle_delivery();
+
         if (ChannelState* state = get_state(packet.dst_chid); LIKELY(state)) {
             state->rx_queue.event.set();
             state->rx_queue.queue.push_back(packet);
@@ -259,6 +321,54 @@ namespace slag {
         return true;
     }
 
+    void Router::interrupt(const ThreadIndex tx_tidx) {
+        const ThreadMask tx_tmask = 1ull << tx_tidx;
+        if (tx_interrupt_mask_ & tx_tmask) {
+            // The last one is still in flight, but the receiver may have already seen it.
+            tx_interrupt_retry_mask_ |= tx_tmask;
+            return;
+        }
+
+        if (UNLIKELY(tx_interrupts_.size() <= tx_tidx)) {
+            tx_interrupts_.resize(tx_tidx + 1);
+        }
+
+        Ptr<InterruptOperation>& operation = tx_interrupts_[tx_tidx];
+        if (operation) {
+            operation->restart(); // Still attached to the reactor, which picks it up again.
+        }
+        else {
+            operation = start_operation<InterruptOperation>(
+                OperationPriority::HIGH,
+                get_runtime().reactor(tx_tidx),
+                Interrupt {
+                    .source = thread_index_,
+                    .reason = InterruptReason::LINK,
+                }
+            );
+        }
+
+        tx_interrupt_selector_.insert<PollableType::COMPLETE>(*operation);
+        tx_interrupt_mask_ |= tx_tmask;
+
+        metrics_.interrupt_count += 1;
+    }
+
+    bool Router::is_transient_error(const int32_t result) {
+        switch (result) {
+            case -EAGAIN:
+            case -EBUSY:
+            case -EINTR:
+            case -ENOMEM:
+            case -EOVERFLOW: { // The receiver's completion queue was full.
+                return true;
+            }
+            default: {
+                return false;
+            }
+        }
+    }
+
     void Router::update_readiness() {
         tx_event_.set(tx_event_mask_ || tx_backlog_mask_);
     }
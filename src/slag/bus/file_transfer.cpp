@@ -0,0 +1,94 @@
+#include "file_transfer.h"
+#include "slag/context.h"
+#include "slag/runtime.h"
+#include "slag/system/operation_factory.h"
+
+namespace slag {
+
+    FileTransferMessage::FileTransferMessage(const FixedFileIndex index)
+        : index_(index)
+    {
+    }
+
+    Ptr<FileDescriptor> FileTransferMessage::take() {
+        Ptr<FileDescriptor> file_descriptor = file_descriptor_;
+        file_descriptor_.reset();
+        return file_descriptor;
+    }
+
+    void FileTransferMessage::handle_delivery() {
+        // Descriptors are finalized on the thread that created them, so the slot is cleared like
+        // any other fixed file of this thread, wherever the last reference is dropped.
+        Ref<FileDescriptor> file_descriptor = make_file_descriptor(-1);
+        file_descriptor->attach_fixed_file(index_);
+        file_descriptor_ = file_descriptor;
+    }
+
+    FileTransfer::FileTransfer(Channel& channel, const ChannelId dst_chid, Ref<FileDescriptor> file_descriptor)
+        : channel_(channel)
+        , dst_chid_(dst_chid)
+        , file_descriptor_(std::move(file_descriptor))
+        , error_(0)
+    {
+    }
+
+    void FileTransfer::run() {
+        SLAG_PT_BEGIN();
+
+        start();
+        if (operation_) {
+            SLAG_PT_WAIT_COMPLETE(*operation_);
+            finish();
+        }
+
+        if (error_) {
+            set_failure();
+        }
+
+        SLAG_PT_END();
+    }
+
+    int32_t FileTransfer::error() const {
+        return error_;
+    }
+
+    void FileTransfer::start() {
+        std::shared_ptr<Reactor> reactor = get_runtime().reactor(dst_chid_.thread_index);
+        if (!reactor->has_capability(Capability::FILE_TRANSFER)) {
+            error_ = -EOPNOTSUPP;
+            return;
+        }
+
+        // Only fixed files can be sent between rings.
+        if (!get_reactor().register_file_descriptor(*file_descriptor_)) {
+            error_ = -ENFILE;
+            return;
+        }
+
+        operation_ = start_send_file_descriptor_operation(std::move(reactor), file_descriptor_);
+    }
+
+    void FileTransfer::finish() {
+        const int32_t result = operation_->result();
+        operation_.reset();
+
+        if (result < 0) {
+            // Stays open here, and is closed when it is finalized.
+            get_reactor().unregister_file_descriptor(*file_descriptor_);
+            error_ = result;
+            return;
+        }
+
+        // The other reactor has its own reference to the file now.
+        get_reactor().unregister_file_descriptor(*file_descriptor_);
+        if (file_descriptor_->borrow() >= 0) {
+            start_close_operation(file_descriptor_->release())->daemonize();
+        }
+
+        channel_.send(
+            dst_chid_,
+            bind(static_cast<Message&>(*new FileTransferMessage(static_cast<FixedFileIndex>(result))))
+        );
+    }
+
+}
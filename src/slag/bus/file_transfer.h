@@ -0,0 +1,54 @@
+#pragma once
+
+#include "slag/core.h"
+#include "slag/object.h"
+#include "slag/bus.h"
+#include "slag/system/file_descriptor.h"
+#include "slag/system/operations/send_file_descriptor_operation.h"
+
+namespace slag {
+
+    // Carries a file that was installed into the receiving thread's fixed file table. A
+    // descriptor of the receiving thread owns the slot from the moment the message arrives, so
+    // the slot is released there even if the message is dropped without being taken.
+    class FileTransferMessage final : public Message {
+    public:
+        explicit FileTransferMessage(FixedFileIndex index);
+
+        // Must be called on the receiving thread. Returns null if it was already taken.
+        Ptr<FileDescriptor> take();
+
+    private:
+        void handle_delivery() override;
+
+    private:
+        FixedFileIndex      index_;
+        Ptr<FileDescriptor> file_descriptor_; // Only addressable through the slot.
+    };
+
+    // Hands a file descriptor to a channel on another thread without duplicating it or blocking
+    // either thread. The file is sent to the other thread's reactor with a msg_ring, and then
+    // its slot is sent to the channel in a FileTransferMessage. The descriptor on this side is
+    // cleared and closed afterwards, so nothing else should be using it.
+    class FileTransfer final : public ProtoTask {
+    public:
+        FileTransfer(Channel& channel, ChannelId dst_chid, Ref<FileDescriptor> file_descriptor);
+
+        void run() override;
+
+        // The error that stopped the transfer, or zero.
+        int32_t error() const;
+
+    private:
+        void start();
+        void finish();
+
+    private:
+        Channel&                         channel_;
+        ChannelId                        dst_chid_;
+        Ref<FileDescriptor>              file_descriptor_;
+        Ptr<SendFileDescriptorOperation> operation_;
+        int32_t                          error_;
+    };
+
+}
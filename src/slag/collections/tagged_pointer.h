@@ -7,14 +7,17 @@ namespace slag {
 
     template<typename T, size_t tag_bits = 3>
     class TaggedPointer {
+    public:
         static constexpr uintptr_t TAG_MASK = (1ull << tag_bits) - 1;
         static constexpr uintptr_t POINTER_MASK = ~TAG_MASK;
 
-    public:
         TaggedPointer();
         explicit TaggedPointer(T* pointer, size_t tag = 0);
         TaggedPointer(const TaggedPointer&) noexcept = default;
 
+        // Reconstructs a tagged pointer from its packed representation.
+        [[nodiscard]] static TaggedPointer from_value(uintptr_t value);
+
         TaggedPointer& operator=(T* pointer);
         TaggedPointer& operator=(const TaggedPointer&) = default;
 
@@ -22,6 +25,8 @@ namespace slag {
         [[nodiscard]] const T* pointer() const;
         void set_pointer(T* pointer);
 
+        [[nodiscard]] uintptr_t value() const;
+
         [[nodiscard]] size_t tag() const;
         void set_tag(size_t tag);
 
@@ -16,6 +16,13 @@ namespace slag {
         assert(tag <= TAG_MASK);
     }
 
+    template<typename T, size_t tag_bits>
+    inline TaggedPointer<T, tag_bits> TaggedPointer<T, tag_bits>::from_value(uintptr_t value) {
+        TaggedPointer tagged_pointer;
+        tagged_pointer.value_ = value;
+        return tagged_pointer;
+    }
+
     template<typename T, size_t tag_bits>
     inline TaggedPointer<T, tag_bits>& slag::TaggedPointer<T, tag_bits>::operator=(T* pointer) {
         set_pointer(pointer);
@@ -38,6 +45,11 @@ namespace slag {
         value_ = (reinterpret_cast<uintptr_t>(pointer) & POINTER_MASK) | (value_ & TAG_MASK);
     }
 
+    template<typename T, size_t tag_bits>
+    inline uintptr_t TaggedPointer<T, tag_bits>::value() const {
+        return value_;
+    }
+
     template<typename T, size_t tag_bits>
     inline size_t TaggedPointer<T, tag_bits>::tag() const {
         return static_cast<size_t>(value_ & TAG_MASK);
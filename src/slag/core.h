@@ -6,3 +6,4 @@
 #include "core/pollable.h"
 #include "core/selector.h"
 #include "core/executor.h"
+#include "core/timer.h"
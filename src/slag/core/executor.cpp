@@ -7,6 +7,10 @@ namespace slag {
         return selector_.readable_event();
     }
 
+    size_t Executor::runnable_count() const {
+        return selector_.ready_count();
+    }
+
     void Executor::schedule(Task& task) {
         Event& event = task.runnable_event();
         if (event.is_linked()) {
@@ -14,6 +14,9 @@ namespace slag {
         void schedule(Task& task);
         void run(size_t budget = 32);
 
+        // The number of tasks that are waiting to run.
+        size_t runnable_count() const;
+
     private:
         Selector selector_;
     };
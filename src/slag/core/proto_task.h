@@ -3,6 +3,9 @@
 #include "slag/core/task.h"
 #include "slag/core/event.h"
 #include "slag/core/pollable.h"
+#include "slag/core/selector.h"
+#include "slag/core/timer.h"
+#include <optional>
 
 #define SLAG_PT_BEGIN()  \
     switch (pt_state_) { \
@@ -48,6 +51,26 @@
 #define SLAG_PT_WAIT_RUNNABLE(pollable) SLAG_PT_WAIT_POLLABLE(pollable, PollableType::RUNNABLE)
 #define SLAG_PT_WAIT_COMPLETE(pollable) SLAG_PT_WAIT_POLLABLE(pollable, PollableType::COMPLETE)
 
+#define SLAG_PT_SLEEP(duration)        \
+    pt_timer().set(duration);          \
+    SLAG_PT_WAIT_READABLE(pt_timer()); \
+
+// Waits until the pollable is ready or the duration elapses. Check `pt_timed_out()` afterwards.
+#define SLAG_PT_WAIT_POLLABLE_FOR(pollable, pollable_type, duration)      \
+    pt_timer().set(duration);                                             \
+    pt_selector_.insert(get_pollable_event<pollable_type>(pollable));     \
+    pt_selector_.insert(pt_timer().readable_event());                     \
+    SLAG_PT_WAIT_READABLE(pt_selector_);                                  \
+    pt_selector_.remove(get_pollable_event<pollable_type>(pollable));     \
+    pt_selector_.remove(pt_timer().readable_event());                     \
+    if (get_pollable_event<pollable_type>(pollable).is_set()) {           \
+        pt_timer().reset();                                               \
+    }                                                                     \
+
+#define SLAG_PT_WAIT_READABLE_FOR(pollable, duration) SLAG_PT_WAIT_POLLABLE_FOR(pollable, PollableType::READABLE, duration)
+#define SLAG_PT_WAIT_WRITABLE_FOR(pollable, duration) SLAG_PT_WAIT_POLLABLE_FOR(pollable, PollableType::WRITABLE, duration)
+#define SLAG_PT_WAIT_COMPLETE_FOR(pollable, duration) SLAG_PT_WAIT_POLLABLE_FOR(pollable, PollableType::COMPLETE, duration)
+
 namespace slag {
 
     // An adaptation of protothreads for our readiness model. To use this,
@@ -81,9 +104,26 @@ namespace slag {
         }
 
     protected:
-        int    pt_state_;
-        bool   pt_yield_;
-        Event* pt_runnable_;
+        // The timer used by the sleep and timed wait macros. Created on first use.
+        Timer& pt_timer() {
+            if (!pt_timer_) {
+                pt_timer_.emplace();
+            }
+
+            return *pt_timer_;
+        }
+
+        // True if the last timed wait expired before the pollable was ready.
+        bool pt_timed_out() const {
+            return pt_timer_ && pt_timer_->is_expired();
+        }
+
+    protected:
+        int                  pt_state_;
+        bool                 pt_yield_;
+        Event*               pt_runnable_;
+        Selector             pt_selector_;
+        std::optional<Timer> pt_timer_;
     };
 
 }
@@ -80,6 +80,15 @@ namespace slag {
         return count;
     }
 
+    void Selector::unselect(Event& event) {
+        assert(event.is_set());
+
+        event.attach(*this);
+        ready_queue_.push_front(event);
+
+        update_readiness();
+    }
+
     bool Selector::is_ready() const {
         return !ready_queue_.is_empty();
     }
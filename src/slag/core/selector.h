@@ -33,6 +33,10 @@ namespace slag {
         Event* select();
         size_t select(std::span<Event*> events);
 
+        // Puts back an event that was just selected but couldn't be handled yet, ahead of the
+        // rest so that it is selected first again.
+        void unselect(Event& event);
+
         // Returns true if a call to select would succeed.
         bool is_ready() const;
 
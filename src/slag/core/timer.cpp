@@ -0,0 +1,238 @@
+#include "timer.h"
+#include "slag/context.h"
+#include "slag/event_loop.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace slag {
+
+    Timer::Timer()
+        : Timer(get_event_loop().timer_wheel())
+    {
+    }
+
+    Timer::Timer(TimerWheel& timer_wheel)
+        : timer_wheel_(timer_wheel)
+        , expiration_tick_(0)
+        , level_(0)
+        , slot_(0)
+    {
+    }
+
+    Timer::~Timer() {
+        reset();
+    }
+
+    Event& Timer::readable_event() {
+        return readable_event_;
+    }
+
+    void Timer::set(const TimePoint deadline) {
+        reset();
+
+        // Round up so that the timer never expires before its deadline.
+        constexpr bool round_up = true;
+        expiration_tick_ = timer_wheel_.to_tick(deadline, round_up);
+        timer_wheel_.schedule(*this);
+    }
+
+    void Timer::reset() {
+        if (is_armed()) {
+            timer_wheel_.cancel(*this);
+        }
+
+        readable_event_.reset();
+    }
+
+    bool Timer::is_armed() const {
+        return hook_.is_linked();
+    }
+
+    bool Timer::is_expired() const {
+        return readable_event_.is_set();
+    }
+
+    TimerWheel::TimerWheel(const TimePoint epoch)
+        : epoch_(epoch)
+        , current_tick_(0)
+        , horizon_tick_(std::numeric_limits<Tick>::max())
+        , size_(0)
+    {
+    }
+
+    TimerWheel::~TimerWheel() {
+        // Timers that are still armed are unlinked when the lists are destroyed; they just won't expire.
+    }
+
+    Event& TimerWheel::readable_event() {
+        return readable_event_;
+    }
+
+    size_t TimerWheel::size() const {
+        return size_;
+    }
+
+    bool TimerWheel::is_empty() const {
+        return size_ == 0;
+    }
+
+    auto TimerWheel::current_tick() const -> Tick {
+        return current_tick_;
+    }
+
+    size_t TimerWheel::advance(const TimePoint now) {
+        constexpr bool round_up = false;
+        const Tick tick = to_tick(now, round_up);
+        if (tick <= current_tick_) {
+            return 0;
+        }
+
+        // Gather the timers in every slot that the wheel passes over on each level. A level
+        // only moves if the one below it wrapped around.
+        TimerList todo;
+        Tick elapsed = tick - current_tick_;
+        for (size_t level = 0; level < LEVEL_COUNT; ++level) {
+            const size_t shift = level * LEVEL_BITS;
+
+            uint64_t pending;
+            if ((elapsed >> shift) > SLOT_MASK) {
+                pending = ~0ull; // A full rotation.
+            }
+            else {
+                const Tick span = SLOT_MASK & (elapsed >> shift);
+                const int old_slot = static_cast<int>(SLOT_MASK & (current_tick_ >> shift));
+                const int new_slot = static_cast<int>(SLOT_MASK & (tick >> shift));
+
+                pending = std::rotl((1ull << span) - 1, old_slot);
+                pending |= std::rotr(std::rotl((1ull << span) - 1, new_slot), static_cast<int>(span));
+                pending |= 1ull << new_slot;
+            }
+
+            Level& wheel_level = levels_[level];
+            while (const uint64_t slots = pending & wheel_level.occupancy) {
+                const int slot = std::countr_zero(slots);
+
+                TimerList& timers = wheel_level.slots[slot];
+                while (!timers.is_empty()) {
+                    todo.push_back(timers.pop_front());
+                    --size_;
+                }
+
+                wheel_level.occupancy &= ~(1ull << slot);
+            }
+
+            if (!(pending & 1)) {
+                break; // This level didn't wrap, so the levels above it didn't move.
+            }
+
+            elapsed = std::max<Tick>(elapsed, SLOT_COUNT << shift);
+        }
+
+        current_tick_ = tick;
+
+        // Timers that are due expire, and the rest cascade down to a lower level.
+        size_t expired_count = 0;
+        while (!todo.is_empty()) {
+            Timer& timer = todo.pop_front();
+            if (timer.expiration_tick_ <= current_tick_) {
+                ++expired_count;
+            }
+
+            schedule(timer);
+        }
+
+        return expired_count;
+    }
+
+    auto TimerWheel::next_expiration() -> std::optional<TimePoint> {
+        readable_event_.reset();
+
+        if (is_empty()) {
+            horizon_tick_ = std::numeric_limits<Tick>::max();
+            return std::nullopt;
+        }
+
+        Tick timeout = std::numeric_limits<Tick>::max();
+        Tick relative_mask = 0;
+        for (size_t level = 0; level < LEVEL_COUNT; ++level) {
+            const size_t shift = level * LEVEL_BITS;
+
+            if (const uint64_t occupancy = levels_[level].occupancy) {
+                const int slot = static_cast<int>(SLOT_MASK & (current_tick_ >> shift));
+
+                // Timers on higher levels are at least one rotation out (or they would be lower),
+                // and the lower levels have already progressed part of the way there.
+                Tick level_timeout = static_cast<Tick>(std::countr_zero(std::rotr(occupancy, slot)) + (level > 0)) << shift;
+                level_timeout -= relative_mask & current_tick_;
+                timeout = std::min(timeout, level_timeout);
+            }
+
+            relative_mask = (relative_mask << LEVEL_BITS) | SLOT_MASK;
+        }
+
+        horizon_tick_ = current_tick_ + timeout;
+        return to_time_point(horizon_tick_);
+    }
+
+    auto TimerWheel::to_tick(const TimePoint time_point, const bool round_up) const -> Tick {
+        if (time_point <= epoch_) {
+            return 0;
+        }
+
+        const Clock::duration offset = time_point - epoch_;
+        Tick tick = static_cast<Tick>(offset / TICK_DURATION);
+        if (round_up && (offset % TICK_DURATION).count()) {
+            tick += 1;
+        }
+
+        return tick;
+    }
+
+    auto TimerWheel::to_time_point(const Tick tick) const -> TimePoint {
+        return epoch_ + (tick * TICK_DURATION);
+    }
+
+    void TimerWheel::schedule(Timer& timer) {
+        assert(!timer.is_armed());
+
+        const Tick expiration = timer.expiration_tick_;
+        if (expiration <= current_tick_) {
+            timer.readable_event_.set();
+            return;
+        }
+
+        // The level is chosen by how far out the timer is, and the slot by its absolute
+        // expiration. Higher levels use the slot before it, so that they are cascaded down
+        // before the timer is due.
+        const Tick remaining = std::min(expiration - current_tick_, MAX_TIMEOUT);
+        const size_t level = (static_cast<size_t>(std::bit_width(remaining)) - 1) / LEVEL_BITS;
+        const size_t slot = SLOT_MASK & ((expiration >> (level * LEVEL_BITS)) - (level > 0));
+
+        Level& wheel_level = levels_[level];
+        wheel_level.slots[slot].push_back(timer);
+        wheel_level.occupancy |= 1ull << slot;
+        timer.level_ = static_cast<uint8_t>(level);
+        timer.slot_ = static_cast<uint8_t>(slot);
+        ++size_;
+
+        if (expiration < horizon_tick_) {
+            readable_event_.set();
+        }
+    }
+
+    void TimerWheel::cancel(Timer& timer) {
+        assert(timer.is_armed());
+
+        Level& wheel_level = levels_[timer.level_];
+        TimerList& timers = wheel_level.slots[timer.slot_];
+
+        timers.erase(timer);
+        if (timers.is_empty()) {
+            wheel_level.occupancy &= ~(1ull << timer.slot_);
+        }
+
+        --size_;
+    }
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include "slag/core/event.h"
+#include "slag/core/pollable.h"
+#include "slag/collections/intrusive_list.h"
+
+namespace slag {
+
+    class TimerWheel;
+
+    // A one-shot timer that becomes readable once its deadline has passed. Timers are
+    // scheduled on a thread's timer wheel, which keeps a single kernel timeout armed
+    // for the earliest deadline instead of having tasks poll the clock.
+    class Timer final : public Pollable<PollableType::READABLE> {
+    public:
+        using Clock     = std::chrono::steady_clock;
+        using TimePoint = Clock::time_point;
+
+        // Uses the timer wheel of the current thread.
+        Timer();
+        explicit Timer(TimerWheel& timer_wheel);
+        ~Timer();
+
+        Timer(Timer&&) = delete;
+        Timer(const Timer&) = delete;
+        Timer& operator=(Timer&&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        Event& readable_event() override;
+
+        template<typename Rep, typename Period>
+        void set(const std::chrono::duration<Rep, Period>& duration);
+        void set(TimePoint deadline);
+
+        // Disarms the timer and clears the expiration.
+        void reset();
+
+        bool is_armed() const;
+        bool is_expired() const;
+
+    private:
+        friend class TimerWheel;
+
+        TimerWheel&       timer_wheel_;
+        IntrusiveListNode hook_;
+        uint64_t          expiration_tick_;
+        uint8_t           level_;
+        uint8_t           slot_;
+        Event             readable_event_;
+    };
+
+    // A hierarchical timing wheel with millisecond ticks. Each level has 64 slots,
+    // and each slot of a level spans a full rotation of the level below it. Timers
+    // are cascaded down to lower levels as the wheel advances, and an occupancy mask
+    // per level lets the wheel skip empty slots when finding the next expiration.
+    //
+    // References:
+    //   http://www.cs.columbia.edu/~nahum/w6998/papers/ton97-timing-wheels.pdf
+    //   https://25thandclement.com/~william/projects/timeout.c.html
+    //
+    class TimerWheel : public Pollable<PollableType::READABLE> {
+    public:
+        using Clock     = Timer::Clock;
+        using TimePoint = Timer::TimePoint;
+        using Tick      = uint64_t;
+
+        static constexpr Clock::duration TICK_DURATION = std::chrono::milliseconds(1);
+        static constexpr size_t          LEVEL_COUNT   = 4;
+        static constexpr size_t          LEVEL_BITS    = 6;
+        static constexpr size_t          SLOT_COUNT    = 1ull << LEVEL_BITS;
+        static constexpr Tick            SLOT_MASK     = SLOT_COUNT - 1;
+        static constexpr Tick            MAX_TIMEOUT   = (1ull << (LEVEL_COUNT * LEVEL_BITS)) - 1;
+
+        explicit TimerWheel(TimePoint epoch = Clock::now());
+        ~TimerWheel();
+
+        TimerWheel(TimerWheel&&) = delete;
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(TimerWheel&&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        // Readable when a timer has been scheduled before the last expiration
+        // returned by `next_expiration`, and the kernel timeout needs to be rearmed.
+        Event& readable_event() override;
+
+        size_t size() const;
+        bool is_empty() const;
+        Tick current_tick() const;
+
+        // Expires every timer with a deadline at or before `now`. Returns the number expired.
+        size_t advance(TimePoint now);
+
+        // Returns when the wheel next needs to be advanced. This can be earlier than the
+        // next deadline if a higher level needs to be cascaded.
+        std::optional<TimePoint> next_expiration();
+
+        Tick to_tick(TimePoint time_point, bool round_up) const;
+        TimePoint to_time_point(Tick tick) const;
+
+    private:
+        friend class Timer;
+
+        void schedule(Timer& timer);
+        void cancel(Timer& timer);
+
+    private:
+        using TimerList = IntrusiveList<Timer, &Timer::hook_>;
+
+        struct Level {
+            uint64_t                           occupancy = 0;
+            std::array<TimerList, SLOT_COUNT> slots;
+        };
+
+        TimePoint                       epoch_;
+        Tick                            current_tick_;
+        Tick                            horizon_tick_;
+        size_t                          size_;
+        std::array<Level, LEVEL_COUNT>  levels_;
+        Event                           readable_event_;
+    };
+
+    template<typename Rep, typename Period>
+    inline void Timer::set(const std::chrono::duration<Rep, Period>& duration) {
+        set(Clock::now() + std::chrono::duration_cast<Clock::duration>(duration));
+    }
+
+}
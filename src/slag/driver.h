@@ -3,6 +3,7 @@
 #include "slag/driver/shutdown_driver.h"
 #include "slag/driver/region_driver.h"
 #include "slag/driver/router_driver.h"
+#include "slag/driver/timer_driver.h"
 
 namespace slag {
 
@@ -14,6 +15,7 @@ namespace slag {
             : shutdown_driver_(event_loop)
             , region_driver_(event_loop)
             , router_driver_(event_loop)
+            , timer_driver_(event_loop)
         {
         }
 
@@ -21,6 +23,7 @@ namespace slag {
         ShutdownDriver shutdown_driver_;
         RegionDriver   region_driver_;
         RouterDriver   router_driver_;
+        TimerDriver    timer_driver_;
     };
 
 }
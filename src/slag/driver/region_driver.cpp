@@ -10,6 +10,8 @@ namespace slag {
             make_file_descriptor(region_.file_descriptor(), FileDescriptor::Ownership::BORROWED)
         )
     {
+        // This is polled for the lifetime of the thread; keep it in the fixed file table.
+        reactor_.register_file_descriptor(*region_fd_);
     }
 
     void RegionDriver::run() {
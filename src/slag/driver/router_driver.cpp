@@ -6,6 +6,7 @@ namespace slag {
     RouterDriver::RouterDriver(EventLoop& event_loop)
         : rx_worker_(event_loop)
         , tx_worker_(event_loop)
+        , interrupt_worker_(event_loop)
     {
     }
 
@@ -45,4 +46,22 @@ namespace slag {
         SLAG_PT_END();
     }
 
+    RouterDriver::InterruptWorker::InterruptWorker(EventLoop& event_loop)
+        : ProtoTask(TaskPriority::HIGH)
+        , event_loop_(event_loop)
+        , router_(event_loop_.router())
+    {
+    }
+
+    void RouterDriver::InterruptWorker::run() {
+        SLAG_PT_BEGIN();
+
+        while (true) {
+            SLAG_PT_WAIT_EVENT(router_.interrupt_event());
+            router_.reap_interrupts();
+        }
+
+        SLAG_PT_END();
+    }
+
 }
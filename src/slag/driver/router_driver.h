@@ -40,9 +40,22 @@ namespace slag {
             Router&    router_;
         };
 
+        // Retries interrupts that failed, or were coalesced while one was in flight.
+        class InterruptWorker final : public ProtoTask {
+        public:
+            explicit InterruptWorker(EventLoop& event_loop);
+
+            void run() override;
+
+        private:
+            EventLoop& event_loop_;
+            Router&    router_;
+        };
+
     private:
-        RxWorker rx_worker_;
-        TxWorker tx_worker_;
+        RxWorker        rx_worker_;
+        TxWorker        tx_worker_;
+        InterruptWorker interrupt_worker_;
     };
 
 }
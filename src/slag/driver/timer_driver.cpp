@@ -0,0 +1,65 @@
+#include "timer_driver.h"
+#include "slag/event_loop.h"
+
+namespace slag {
+
+    TimerDriver::TimerDriver(EventLoop& event_loop)
+        : ProtoTask(TaskPriority::HIGH)
+        , timer_wheel_(event_loop.timer_wheel())
+    {
+    }
+
+    void TimerDriver::run() {
+        SLAG_PT_BEGIN();
+
+        selector_.insert(timer_wheel_.readable_event());
+
+        while (true) {
+            if (timeout_ && timeout_->is_complete()) {
+                timeout_.reset();
+            }
+
+            timer_wheel_.advance(Timer::Clock::now());
+
+            // Only rearm if the next expiration moved earlier. A later one just costs a spurious wakeup.
+            if (std::optional<Timer::TimePoint> deadline = timer_wheel_.next_expiration()) {
+                if (!timeout_ || (*deadline < timeout_->deadline())) {
+                    arm(*deadline);
+                }
+            }
+
+            SLAG_PT_WAIT_READABLE(selector_);
+            {
+                Event& wheel_event = timer_wheel_.readable_event();
+
+                bool wheel_selected = false;
+                while (Event* event = selector_.select()) {
+                    wheel_selected |= (event == &wheel_event);
+                }
+
+                // Keep watching the wheel. Its event is reset by `next_expiration`.
+                if (wheel_selected) {
+                    selector_.insert(wheel_event);
+                }
+            }
+        }
+
+        SLAG_PT_END();
+    }
+
+    void TimerDriver::arm(const Timer::TimePoint deadline) {
+        disarm();
+
+        timeout_ = start_timer_operation(deadline);
+        selector_.insert<PollableType::COMPLETE>(*timeout_);
+    }
+
+    void TimerDriver::disarm() {
+        if (timeout_) {
+            selector_.remove(timeout_->complete_event());
+            timeout_->cancel();
+            timeout_.reset();
+        }
+    }
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "slag/object.h"
+#include "slag/core.h"
+#include "slag/system/reactor.h"
+#include "slag/system/operation_factory.h"
+#include "slag/system/operations/timer_operation.h"
+
+#include <cassert>
+
+namespace slag {
+
+    class EventLoop;
+
+    // Advances the thread's timer wheel, and keeps a single kernel timeout armed
+    // for the wheel's next expiration so that idle threads can block in the reactor.
+    class TimerDriver final : public ProtoTask {
+    public:
+        explicit TimerDriver(EventLoop& event_loop);
+
+        void run() override;
+
+    private:
+        void arm(Timer::TimePoint deadline);
+        void disarm();
+
+    private:
+        TimerWheel&         timer_wheel_;
+        Ptr<TimerOperation> timeout_;
+        Selector            selector_;
+    };
+
+}
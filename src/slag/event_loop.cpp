@@ -5,6 +5,8 @@
 #include "slag/memory.h"
 #include "slag/system.h"
 #include "slag/core.h"
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
 
 namespace slag {
@@ -13,8 +15,17 @@ namespace slag {
         : region_(components.domain, *this)
         , router_(std::move(components.fabric), thread_index)
         , reactor_(std::move(components.reactor))
+        , thread_load_(router_.fabric().thread_load(thread_index))
         , current_priority_(TaskPriority::HIGH) // This will give the root task high-priority.
+        , idle_policy_(components.idle_policy)
     {
+        if (idle_policy_.min_spin_window > idle_policy_.max_spin_window) {
+            throw std::runtime_error("Invalid idle policy");
+        }
+
+        metrics_.spin_window = idle_policy_.min_spin_window;
+
+        reactor_->enable();
     }
 
     bool EventLoop::is_running() const {
@@ -33,6 +44,10 @@ namespace slag {
         return *reactor_;
     }
 
+    TimerWheel& EventLoop::timer_wheel() {
+        return timer_wheel_;
+    }
+
     Executor& EventLoop::executor(TaskPriority priority) {
         if (priority == TaskPriority::SAME) {
             priority = current_priority_;
@@ -73,6 +88,10 @@ namespace slag {
         }
     }
 
+    auto EventLoop::metrics() const -> const Metrics& {
+        return metrics_;
+    }
+
     void EventLoop::finalize(ObjectGroup group, std::span<Object*> objects) noexcept {
         // TODO: Defer this and have an `GarbageCollectorDriver` do it.
 
@@ -106,18 +125,35 @@ namespace slag {
     }
 
     void EventLoop::finalize(Buffer& buffer) {
-        // TODO: Manage buffer pools.
-        delete &buffer;
+        if (BufferPool* pool = buffer.pool()) {
+            pool->reclaim(buffer);
+        }
+        else {
+            delete &buffer;
+        }
     }
 
     void EventLoop::finalize(FileDescriptor& file_descriptor) {
-        if (is_running() && file_descriptor) {
-            start_close_operation(file_descriptor.release())->daemonize();
+        // Operations keep their file descriptor alive, so nothing is in flight on it by now.
+        // Busy descriptors are torn down with a CancelOperation, which makes abandoning the
+        // operations that it covered free (see `finalize(Operation&)`).
+        if (is_running()) {
+            if (file_descriptor.is_fixed()) {
+                reactor_->unregister_file_descriptor(file_descriptor);
+            }
+            if (file_descriptor.borrow() >= 0) {
+                start_close_operation(file_descriptor.release())->daemonize();
+            }
         }
 
         delete &file_descriptor;
     }
 
+    void EventLoop::finalize(Pipe& pipe) {
+        // The ends are finalized (and closed) like any other file descriptor.
+        delete &pipe;
+    }
+
     void EventLoop::finalize(Operation& operation) {
         operation.abandon();
 
@@ -128,7 +164,7 @@ namespace slag {
             reactor_->destroy_operation(operation);
         }
         else {
-            operation.cancel();
+            operation.cancel(); // Doesn't submit anything if its file descriptor was canceled.
         }
     }
 
@@ -145,13 +181,16 @@ namespace slag {
             }
 
             // Submit I/O operations and poll for completions.
-            {
-                bool non_blocking = false;
-                non_blocking |= high_priority_executor_.is_runnable();
-                non_blocking |= idle_priority_executor_.is_runnable();
-
+            if (has_work()) {
+                constexpr bool non_blocking = true;
                 reactor_->poll(non_blocking);
+                router_.wake();
             }
+            else {
+                idle();
+            }
+
+            publish_load();
 
             // Execute tasks for awhile.
             if (high_priority_executor_.is_runnable()) {
@@ -165,4 +204,94 @@ namespace slag {
         }
     }
 
+    void EventLoop::idle() {
+        if (!spin()) {
+            block();
+        }
+    }
+
+    bool EventLoop::spin() {
+        using Clock = std::chrono::steady_clock;
+
+        if (idle_policy_.mode == IdlePolicy::Mode::BLOCK) {
+            return false;
+        }
+
+        // Spinning threads still come up for air, so that the region can make progress.
+        const bool forever = idle_policy_.mode == IdlePolicy::Mode::SPIN;
+        const Clock::time_point start = Clock::now();
+        const Clock::time_point deadline = start + (forever ? idle_policy_.max_spin_window : metrics_.spin_window);
+
+        bool hit = false;
+        Clock::time_point now = start;
+        do {
+            constexpr bool non_blocking = true;
+            reactor_->poll(non_blocking);
+            router_.wake();
+
+            if (has_work()) {
+                hit = true;
+                break;
+            }
+
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+            now = Clock::now();
+        } while (now < deadline);
+
+        metrics_.spin_count += 1;
+        metrics_.spin_time += now - start;
+
+        if (hit) {
+            metrics_.spin_hits += 1;
+        }
+        else if (!forever) {
+            // Nothing showed up, so this much spinning is wasted. Back off.
+            metrics_.spin_window = std::max(idle_policy_.min_spin_window, metrics_.spin_window / 2);
+        }
+
+        return hit || forever;
+    }
+
+    void EventLoop::block() {
+        using Clock = std::chrono::steady_clock;
+
+        // Other threads skip interrupting us unless we might block, so check with them first.
+        const bool non_blocking = !router_.sleep();
+
+        const Clock::time_point start = Clock::now();
+        reactor_->poll(non_blocking);
+        router_.wake();
+        const Clock::duration blocked_time = Clock::now() - start;
+
+        if (non_blocking) {
+            return;
+        }
+
+        metrics_.wakeup_count += 1;
+        metrics_.blocked_time += blocked_time;
+
+        // Spinning a bit longer would have caught this wakeup without the trip through the kernel.
+        if ((idle_policy_.mode == IdlePolicy::Mode::HYBRID) && (blocked_time < idle_policy_.max_spin_window)) {
+            metrics_.spin_window = std::min<std::chrono::nanoseconds>(
+                idle_policy_.max_spin_window,
+                std::max<std::chrono::nanoseconds>(metrics_.spin_window * 2, blocked_time)
+            );
+        }
+    }
+
+    void EventLoop::publish_load() {
+        const size_t load =
+            high_priority_executor_.runnable_count() +
+            idle_priority_executor_.runnable_count() +
+            reactor_->in_flight_count();
+
+        thread_load_.publish(static_cast<uint32_t>(std::min<size_t>(load, std::numeric_limits<uint32_t>::max())));
+    }
+
+    bool EventLoop::has_work() const {
+        return high_priority_executor_.is_runnable() || idle_priority_executor_.is_runnable();
+    }
+
 }
@@ -6,6 +6,7 @@
 #include "slag/system.h"
 #include "slag/driver.h"
 
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -14,12 +15,40 @@ namespace slag {
 
     class Thread;
 
+    // How the event loop waits once it runs out of work. Spinning keeps polling the reactor and
+    // links, which saves a trip through the kernel for each wakeup and lets other threads skip
+    // interrupting this one, at the cost of a busy core.
+    struct IdlePolicy {
+        enum class Mode : uint8_t {
+            BLOCK,  // Block in the reactor right away (background threads).
+            SPIN,   // Never block (latency critical threads).
+            HYBRID, // Spin for a while before blocking.
+        };
+
+        Mode mode = Mode::BLOCK;
+
+        // The hybrid spin window adapts between these. It grows when the thread is woken soon
+        // after blocking, and shrinks when it spins without finding work.
+        std::chrono::nanoseconds min_spin_window = std::chrono::microseconds(0);
+        std::chrono::nanoseconds max_spin_window = std::chrono::microseconds(200);
+    };
+
     class EventLoop final : private Finalizer {
     public:
         struct Components {
             Domain&                  domain;
             std::shared_ptr<Fabric>  fabric;
             std::shared_ptr<Reactor> reactor;
+            IdlePolicy               idle_policy = IdlePolicy{};
+        };
+
+        struct Metrics {
+            size_t                   spin_count   = 0; // Times the loop went idle and spun.
+            size_t                   spin_hits    = 0; // Spins that found work before the window closed.
+            size_t                   wakeup_count = 0; // Times the loop blocked in the reactor.
+            std::chrono::nanoseconds spin_time    = {};
+            std::chrono::nanoseconds blocked_time = {};
+            std::chrono::nanoseconds spin_window  = {}; // The current hybrid spin window.
         };
 
         EventLoop(ThreadIndex thread_index, Components components);
@@ -35,6 +64,7 @@ namespace slag {
         Region& region();
         Router& router();
         Reactor& reactor();
+        TimerWheel& timer_wheel();
         Executor& executor(TaskPriority priority);
 
         template<typename RootTask, typename... Args>
@@ -43,6 +73,8 @@ namespace slag {
 
         void stop(bool force = false);
 
+        const Metrics& metrics() const;
+
     private:
         void finalize(ObjectGroup group, std::span<Object*> objects) noexcept override;
 
@@ -50,21 +82,34 @@ namespace slag {
         void finalize(Message& message);
         void finalize(Buffer& buffer);
         void finalize(FileDescriptor& file_descriptor);
+        void finalize(Pipe& pipe);
         void finalize(Operation& operation);
 
     private:
         void loop();
 
+        // Waits for work according to the idle policy.
+        void idle();
+        bool spin();
+        void block();
+        bool has_work() const;
+        void publish_load();
+
     private:
         Region                        region_;
         Router                        router_;
         std::shared_ptr<Reactor>      reactor_;
+        ThreadLoad&                   thread_load_;
         InterruptVector               interrupt_vector_;
+        TimerWheel                    timer_wheel_;
 
         TaskPriority                  current_priority_;
         Executor                      high_priority_executor_;
         Executor                      idle_priority_executor_;
 
+        IdlePolicy                    idle_policy_;
+        Metrics                       metrics_;
+
         std::optional<Drivers>        drivers_;
         std::unique_ptr<Task>         root_task_;
     };
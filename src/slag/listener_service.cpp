@@ -0,0 +1,233 @@
+#include "listener_service.h"
+#include "slag/context.h"
+#include "slag/thread.h"
+#include <stdexcept>
+#include <limits>
+#include <cstring>
+
+namespace slag {
+
+    Ref<FileDescriptor> make_listening_socket(const struct sockaddr& address, const socklen_t address_length, const int backlog, const bool reuse_port) {
+        const int raw_socket = ::socket(address.sa_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (raw_socket < 0) {
+            throw std::runtime_error(strerror(errno));
+        }
+
+        // Closed if anything below fails.
+        Ref<FileDescriptor> socket = make_file_descriptor(raw_socket);
+
+        const int enable = 1;
+        if (setsockopt(raw_socket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) < 0) {
+            throw std::runtime_error(strerror(errno));
+        }
+        if (reuse_port && (setsockopt(raw_socket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0)) {
+            throw std::runtime_error(strerror(errno));
+        }
+        if (::bind(raw_socket, &address, address_length) < 0) {
+            throw std::runtime_error(strerror(errno));
+        }
+        if (::listen(raw_socket, backlog) < 0) {
+            throw std::runtime_error(strerror(errno));
+        }
+
+        return socket;
+    }
+
+    ListenerShard::ListenerShard(const ListenerServiceConfig& config)
+        : error_(0)
+    {
+        switch (config.mode) {
+            case ListenerMode::SHARDED: {
+                constexpr bool reuse_port = true;
+                listener_.emplace(
+                    make_listening_socket(
+                        reinterpret_cast<const struct sockaddr&>(config.address),
+                        config.address_length,
+                        config.backlog,
+                        reuse_port
+                    ),
+                    config.direct_accept
+                );
+                break;
+            }
+            case ListenerMode::BALANCED: {
+                channel_.emplace(channel_name(config.name, get_thread().index()));
+                break;
+            }
+        }
+    }
+
+    Event& ListenerShard::readable_event() {
+        if (listener_) {
+            return listener_->readable_event();
+        }
+
+        return channel_->readable_event();
+    }
+
+    Ptr<FileDescriptor> ListenerShard::accept() {
+        if (listener_) {
+            return listener_->accept();
+        }
+
+        while (Ptr<Message> message = channel_->receive()) {
+            auto transfer = dynamic_cast<FileTransferMessage*>(&*message);
+            if (!transfer) {
+                error_ = -EPROTO; // Only the balancer is meant to send here.
+                continue;
+            }
+
+            if (Ptr<FileDescriptor> connection = transfer->take()) {
+                return connection;
+            }
+        }
+
+        return {};
+    }
+
+    int32_t ListenerShard::error() const {
+        return listener_ ? listener_->error() : error_;
+    }
+
+    std::string ListenerShard::channel_name(const std::string& service_name, const ThreadIndex thread_index) {
+        return service_name + "." + std::to_string(thread_index);
+    }
+
+    WorkerSelector::WorkerSelector(Fabric& fabric)
+        : fabric_(fabric)
+        , assigned_counts_{}
+        , observed_epochs_{}
+    {
+    }
+
+    std::optional<ThreadIndex> WorkerSelector::select(const ThreadMask candidates) {
+        std::optional<ThreadIndex> worker;
+        uint64_t worker_load = std::numeric_limits<uint64_t>::max();
+
+        for_each_thread(candidates, [&](const ThreadIndex tidx) {
+            const ThreadLoad& thread_load = fabric_.thread_load(tidx);
+            if (const uint32_t epoch = thread_load.epoch(); epoch != observed_epochs_[tidx]) {
+                observed_epochs_[tidx] = epoch;
+                assigned_counts_[tidx] = 0;
+            }
+
+            const uint64_t load = uint64_t{thread_load.load()} + assigned_counts_[tidx];
+            if (load < worker_load) {
+                worker = tidx;
+                worker_load = load;
+            }
+        });
+
+        if (worker) {
+            assigned_counts_[*worker] += 1;
+        }
+
+        return worker;
+    }
+
+    ListenerBalancer::ListenerBalancer(const ListenerServiceConfig& config)
+        : config_(config)
+        , listener_(
+            make_listening_socket(
+                reinterpret_cast<const struct sockaddr&>(config_.address),
+                config_.address_length,
+                config_.backlog,
+                false // reuse_port
+            ),
+            true // direct: connections are sent to the workers as fixed files anyway
+        )
+        , worker_selector_(get_router().fabric())
+        , error_(0)
+    {
+        selector_.insert(listener_.readable_event());
+    }
+
+    ListenerBalancer::~ListenerBalancer() {
+        selector_.remove(listener_.readable_event());
+        for (FileTransfer& transfer: transfers_) {
+            selector_.remove(transfer.complete_event());
+        }
+    }
+
+    void ListenerBalancer::run() {
+        SLAG_PT_BEGIN();
+
+        while (true) {
+            // Finished transfers are reaped as they complete, rather than with the next connection.
+            SLAG_PT_WAIT_READABLE(selector_);
+            while (Ptr<FileDescriptor> connection = listener_.accept()) {
+                dispatch(std::move(connection));
+            }
+
+            reap_transfers();
+
+            if (listener_.error()) {
+                error_ = listener_.error();
+                break;
+            }
+        }
+
+        // Let the connections that are on their way arrive.
+        while (!transfers_.empty()) {
+            SLAG_PT_WAIT_COMPLETE(transfers_.front());
+            reap_transfers();
+        }
+
+        set_failure();
+
+        SLAG_PT_END();
+    }
+
+    int32_t ListenerBalancer::error() const {
+        return error_;
+    }
+
+    auto ListenerBalancer::metrics() const -> const Metrics& {
+        return metrics_;
+    }
+
+    std::optional<ThreadIndex> ListenerBalancer::select_worker() {
+        ThreadMask candidates = 0;
+        for_each_thread(config_.workers, [&](const ThreadIndex tidx) {
+            std::optional<ChannelId>& chid = worker_channels_[tidx];
+            if (!chid) {
+                chid = channel_.query(ListenerShard::channel_name(config_.name, tidx));
+            }
+            if (chid) {
+                candidates |= 1ull << tidx; // Otherwise the shard isn't up yet.
+            }
+        });
+
+        return worker_selector_.select(candidates);
+    }
+
+    void ListenerBalancer::dispatch(Ptr<FileDescriptor> connection) {
+        metrics_.accept_count += 1;
+
+        const std::optional<ThreadIndex> worker = select_worker();
+        if (!worker) {
+            metrics_.drop_count += 1;
+            return; // Closed when it is finalized.
+        }
+
+        transfers_.emplace_back(channel_, *worker_channels_[*worker], bind(*connection));
+        selector_.insert(transfers_.back().complete_event());
+    }
+
+    void ListenerBalancer::reap_transfers() {
+        for (auto it = transfers_.begin(); it != transfers_.end(); ) {
+            if (!it->is_complete()) {
+                ++it;
+                continue;
+            }
+
+            if (it->error()) {
+                metrics_.transfer_failure_count += 1;
+            }
+
+            selector_.remove(it->complete_event());
+            it = transfers_.erase(it);
+        }
+    }
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <array>
+#include <list>
+#include <optional>
+#include <string>
+#include "slag/core.h"
+#include "slag/object.h"
+#include "slag/bus.h"
+#include "slag/bus/file_transfer.h"
+#include "slag/system/listener.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    enum class ListenerMode : uint8_t {
+        SHARDED,  // Each worker accepts on its own SO_REUSEPORT socket, and the kernel spreads connections.
+        BALANCED, // One thread accepts, and hands each connection to the least loaded worker.
+    };
+
+    struct ListenerServiceConfig {
+        ListenerMode            mode           = ListenerMode::SHARDED;
+        std::string             name;          // Balanced connections are delivered to channels named after this.
+        struct sockaddr_storage address        = {};
+        socklen_t               address_length = 0;
+        int                     backlog        = SOMAXCONN;
+        ThreadMask              workers        = 0; // The threads that balanced connections are spread over.
+
+        // Sharded workers accept connections as direct descriptors, which are only usable through
+        // the ring (balanced workers always receive them that way).
+        bool                    direct_accept  = false;
+    };
+
+    // Creates a socket that is bound to the address and listening.
+    Ref<FileDescriptor> make_listening_socket(const struct sockaddr& address, socklen_t address_length, int backlog, bool reuse_port);
+
+    // The end of a listener service on each worker thread. It is readable when a connection can
+    // be accepted, whichever mode the service is in.
+    class ListenerShard final : public Pollable<PollableType::READABLE> {
+    public:
+        explicit ListenerShard(const ListenerServiceConfig& config);
+
+        ListenerShard(ListenerShard&&) = delete;
+        ListenerShard(const ListenerShard&) = delete;
+        ListenerShard& operator=(ListenerShard&&) = delete;
+        ListenerShard& operator=(const ListenerShard&) = delete;
+
+        Event& readable_event() override;
+
+        // Returns the next connection, if there is one.
+        Ptr<FileDescriptor> accept();
+
+        // The error that stopped a sharded listener, -EPROTO once a balanced shard has received
+        // something other than a connection (it keeps accepting), or zero.
+        int32_t error() const;
+
+        static std::string channel_name(const std::string& service_name, ThreadIndex thread_index);
+
+    private:
+        std::optional<Listener> listener_; // Sharded
+        std::optional<Channel>  channel_;  // Balanced
+        int32_t                 error_;
+    };
+
+    // Picks the least loaded of a set of threads from the loads they publish. Loads are only
+    // published once per loop iteration, so what was handed to each thread since then is
+    // counted on top, to avoid piling onto the same thread in a burst.
+    class WorkerSelector {
+    public:
+        explicit WorkerSelector(Fabric& fabric);
+
+        // Returns the selected thread, and counts it as having been handed one more unit of work.
+        std::optional<ThreadIndex> select(ThreadMask candidates);
+
+    private:
+        Fabric&                                fabric_;
+        std::array<uint32_t, MAX_THREAD_COUNT> assigned_counts_;
+        std::array<uint32_t, MAX_THREAD_COUNT> observed_epochs_;
+    };
+
+    // Accepts connections for a balanced listener service, and hands each of them to the worker
+    // with the least work queued (runnable tasks plus operations in flight). Runs on its own
+    // thread until the listener fails.
+    class ListenerBalancer final : public ProtoTask {
+    public:
+        struct Metrics {
+            size_t accept_count           = 0;
+            size_t transfer_failure_count = 0;
+            size_t drop_count             = 0; // Connections closed because no worker was up yet.
+        };
+
+        explicit ListenerBalancer(const ListenerServiceConfig& config);
+        ~ListenerBalancer();
+
+        void run() override;
+
+        // The error that stopped the listener, or zero.
+        int32_t error() const;
+
+        const Metrics& metrics() const;
+
+    private:
+        std::optional<ThreadIndex> select_worker();
+        void dispatch(Ptr<FileDescriptor> connection);
+        void reap_transfers();
+
+    private:
+        ListenerServiceConfig                                  config_;
+        Listener                                               listener_;
+        Channel                                                channel_;
+        std::array<std::optional<ChannelId>, MAX_THREAD_COUNT> worker_channels_;
+        WorkerSelector                                         worker_selector_;
+        std::list<FileTransfer>                                transfers_;
+        Selector                                               selector_; // The listener, and the transfers in flight.
+        int32_t                                                error_;
+        Metrics                                                metrics_;
+    };
+
+}
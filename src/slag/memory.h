@@ -2,4 +2,5 @@
 
 #include "memory/allocator.h"
 #include "memory/buffer.h"
+#include "memory/slab_pool.h"
 
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <span>
+#include <optional>
 #include <vector>
 #include <stdexcept>
+#include <cassert>
 #include <cstdint>
 #include <cstddef>
 
@@ -11,6 +13,22 @@
 
 namespace slag {
 
+    // Buffers that belong to a pool are handed back to it when they are
+    // finalized instead of being deleted.
+    class BufferPool {
+    public:
+        virtual ~BufferPool() = default;
+
+        virtual void reclaim(Buffer& buffer) = 0;
+
+        // Pools that register their buffers with the ring report where a buffer is in the
+        // ring's buffer table, so that operations can use the fixed variants.
+        virtual std::optional<uint16_t> registered_index(const Buffer& buffer) const {
+            (void)buffer;
+            return std::nullopt;
+        }
+    };
+
     // TODO: Use private memory mappings (huge-pages) as a backing store.
     //
     template<>
@@ -19,9 +37,37 @@ namespace slag {
         explicit Resource(const size_t capacity)
             : Object(static_cast<ObjectGroup>(ResourceType::BUFFER))
             , storage_(capacity)
+            , pool_(nullptr)
+            , pool_index_(0)
         {
         }
 
+        BufferPool* pool() {
+            return pool_;
+        }
+
+        const BufferPool* pool() const {
+            return pool_;
+        }
+
+        // The position of this buffer within its pool.
+        uint32_t pool_index() const {
+            return pool_index_;
+        }
+
+        void attach_pool(BufferPool& pool, uint32_t pool_index) {
+            assert(!pool_);
+
+            pool_ = &pool;
+            pool_index_ = pool_index;
+        }
+
+        // Orphaned buffers will be deleted when they are finalized.
+        void detach_pool() {
+            pool_ = nullptr;
+            pool_index_ = 0;
+        }
+
         std::span<std::byte> storage() {
             return {
                 storage_.data(),
@@ -38,6 +84,8 @@ namespace slag {
 
     private:
         std::vector<std::byte> storage_;
+        BufferPool*            pool_;
+        uint32_t               pool_index_;
     };
 
     class BufferSlice {
@@ -56,6 +104,14 @@ namespace slag {
             assert(selection_.end() <= buffer_->storage().end());
         }
 
+        Buffer& buffer() {
+            return *buffer_;
+        }
+
+        const Buffer& buffer() const {
+            return *buffer_;
+        }
+
         std::span<std::byte> selection() {
             return selection_;
         }
@@ -69,4 +125,15 @@ namespace slag {
         std::span<std::byte> selection_;
     };
 
+    // The index of the slice's buffer in the ring's registered buffer table, if it has one.
+    inline std::optional<uint16_t> registered_buffer_index(const BufferSlice& slice) {
+        const Buffer& buffer = slice.buffer();
+
+        if (const BufferPool* pool = buffer.pool()) {
+            return pool->registered_index(buffer);
+        }
+
+        return std::nullopt;
+    }
+
 }
@@ -0,0 +1,95 @@
+#include "slab_pool.h"
+#include <algorithm>
+#include <new>
+#include <cassert>
+
+namespace slag {
+
+    SlabPool::SlabPool(const size_t block_size, const size_t block_alignment, const size_t blocks_per_slab)
+        : block_alignment_(std::max(block_alignment, alignof(FreeBlock)))
+        , blocks_per_slab_(blocks_per_slab)
+        , free_list_(nullptr)
+    {
+        assert(blocks_per_slab_ > 0);
+        assert((block_alignment_ & (block_alignment_ - 1)) == 0);
+
+        // Round up so that every block in a slab stays aligned.
+        block_size_ = std::max(block_size, sizeof(FreeBlock));
+        block_size_ = (block_size_ + block_alignment_ - 1) & ~(block_alignment_ - 1);
+    }
+
+    SlabPool::~SlabPool() {
+        for (std::byte* slab: slabs_) {
+            ::operator delete(slab, std::align_val_t{block_alignment_});
+        }
+    }
+
+    size_t SlabPool::block_size() const {
+        return block_size_;
+    }
+
+    size_t SlabPool::block_alignment() const {
+        return block_alignment_;
+    }
+
+    auto SlabPool::metrics() const -> const Metrics& {
+        return metrics_;
+    }
+
+    void* SlabPool::allocate() {
+        uint64_t tag;
+        return allocate(tag);
+    }
+
+    void SlabPool::deallocate(void* block) {
+        deallocate(block, 0);
+    }
+
+    void* SlabPool::allocate(uint64_t& tag) {
+        if (!free_list_) {
+            grow();
+        }
+
+        FreeBlock* block = free_list_;
+        free_list_ = block->next;
+        tag = block->tag;
+
+        metrics_.allocate_count += 1;
+        metrics_.size += 1;
+        metrics_.high_water_mark = std::max(metrics_.high_water_mark, metrics_.size);
+
+        return block;
+    }
+
+    void SlabPool::deallocate(void* block, const uint64_t tag) {
+        assert(block);
+        assert(metrics_.size > 0);
+
+        FreeBlock* free_block = new(block) FreeBlock;
+        free_block->next = free_list_;
+        free_block->tag = tag;
+        free_list_ = free_block;
+
+        metrics_.deallocate_count += 1;
+        metrics_.size -= 1;
+    }
+
+    void SlabPool::grow() {
+        std::byte* slab = static_cast<std::byte*>(
+            ::operator new(block_size_ * blocks_per_slab_, std::align_val_t{block_alignment_})
+        );
+        slabs_.push_back(slab);
+
+        // Thread the blocks in address order.
+        for (size_t i = blocks_per_slab_; i > 0; --i) {
+            FreeBlock* block = new(slab + ((i - 1) * block_size_)) FreeBlock;
+            block->next = free_list_;
+            block->tag = 0;
+            free_list_ = block;
+        }
+
+        metrics_.slab_count += 1;
+        metrics_.capacity += blocks_per_slab_;
+    }
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace slag {
+
+    // Hands out fixed-size blocks carved from larger slabs, and keeps freed blocks on an
+    // intrusive free list for reuse. Slabs are only released when the pool is destroyed.
+    class SlabPool {
+    public:
+        struct Metrics {
+            size_t allocate_count   = 0;
+            size_t deallocate_count = 0;
+            size_t slab_count       = 0;
+            size_t capacity         = 0; // Blocks across all slabs.
+            size_t size             = 0; // Blocks in use.
+            size_t high_water_mark  = 0;
+        };
+
+        SlabPool(size_t block_size, size_t block_alignment, size_t blocks_per_slab = 64);
+        ~SlabPool();
+
+        SlabPool(SlabPool&&) = delete;
+        SlabPool(const SlabPool&) = delete;
+        SlabPool& operator=(SlabPool&&) = delete;
+        SlabPool& operator=(const SlabPool&) = delete;
+
+        size_t block_size() const;
+        size_t block_alignment() const;
+        const Metrics& metrics() const;
+
+        [[nodiscard]]
+        void* allocate();
+        void deallocate(void* block);
+
+        // Freed blocks keep a tag until they are allocated again, so that the owner can carry
+        // state across reuses of the same block. Fresh blocks have a zero tag.
+        [[nodiscard]]
+        void* allocate(uint64_t& tag);
+        void deallocate(void* block, uint64_t tag);
+
+    private:
+        void grow();
+
+    private:
+        struct FreeBlock {
+            FreeBlock* next;
+            uint64_t   tag;
+        };
+
+        size_t                  block_size_;
+        size_t                  block_alignment_;
+        size_t                  blocks_per_slab_;
+        FreeBlock*              free_list_;
+        std::vector<std::byte*> slabs_;
+        Metrics                 metrics_;
+    };
+
+}
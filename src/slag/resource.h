@@ -9,6 +9,7 @@
     X(MESSAGE)                     \
     X(BUFFER)                      \
     X(FILE_DESCRIPTOR)             \
+    X(PIPE)                        \
     X(OPERATION)                   \
 
 // Resource types can be injected by defining this.
@@ -47,6 +48,7 @@ namespace slag {
     using Message        = Resource<ResourceType::MESSAGE>;
     using Buffer         = Resource<ResourceType::BUFFER>;
     using FileDescriptor = Resource<ResourceType::FILE_DESCRIPTOR>;
+    using Pipe           = Resource<ResourceType::PIPE>;
     using Operation      = Resource<ResourceType::OPERATION>;
 
     constexpr bool is_lib_resource(ResourceType type) {
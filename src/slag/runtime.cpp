@@ -18,6 +18,9 @@ namespace slag {
             std::scoped_lock lock(mutex_);
             thread_count = threads_.size();
         }
+
+        // Join the threads while their reactors are still around.
+        threads_.clear();
         if (thread_count == 0) {
             // Unblock the domain so we can shutdown.
             Region dummy_region(domain_, *this);
@@ -54,8 +54,19 @@ namespace slag {
         Thread& thread = [&]() -> Thread& {
             std::scoped_lock lock(mutex_);
 
+            // Polling reactors attach to the first one so they share a polling thread and workers.
+            int shared_workers_file_descriptor = -1;
+            if (config.reactor.submission_polling) {
+                for (const std::shared_ptr<Reactor>& reactor: reactors_) {
+                    if (reactor->is_submission_polling()) {
+                        shared_workers_file_descriptor = reactor->borrow_file_descriptor();
+                        break;
+                    }
+                }
+            }
+
             // The thread expects the corresponding reactor to be available upon construction.
-            reactors_.push_back(std::make_shared<Reactor>());
+            reactors_.push_back(std::make_shared<Reactor>(config.reactor, shared_workers_file_descriptor));
 
             const ThreadIndex tidx = static_cast<ThreadIndex>(threads_.size());
             return *threads_.emplace_back(std::make_unique<Thread>(*this, tidx, config));
@@ -8,3 +8,6 @@
 #include "core.h"
 #include "memory.h"
 #include "system.h"
+#include "bus.h"
+#include "bus/file_transfer.h"
+#include "listener_service.h"
@@ -4,4 +4,7 @@
 #include "system/operation.h"
 #include "system/interrupt.h"
 #include "system/file_descriptor.h"
+#include "system/pipe.h"
 #include "system/operation_factory.h"
+#include "system/listener.h"
+#include "system/relay.h"
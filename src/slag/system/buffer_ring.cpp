@@ -0,0 +1,101 @@
+#include "buffer_ring.h"
+#include <stdexcept>
+#include <cstring>
+#include <cassert>
+
+namespace slag {
+
+    BufferRing::BufferRing(struct io_uring& ring, const GroupId group_id, const size_t buffer_count, const size_t buffer_size)
+        : ring_(ring)
+        , buf_ring_(nullptr)
+        , group_id_(group_id)
+        , buffer_size_(buffer_size)
+        , selected_count_(0)
+    {
+        // The kernel requires a power-of-two ring, and buffer ids are 16 bits.
+        if ((buffer_count == 0) || (buffer_count > 32768) || (buffer_count & (buffer_count - 1))) {
+            throw std::runtime_error("Invalid buffer ring size");
+        }
+
+        int result = 0;
+        buf_ring_ = io_uring_setup_buf_ring(&ring_, static_cast<unsigned>(buffer_count), group_id_, 0, &result);
+        if (!buf_ring_) {
+            throw std::runtime_error(strerror(-result));
+        }
+
+        buffers_.reserve(buffer_count);
+        selected_.resize(buffer_count, false);
+
+        for (size_t buffer_id = 0; buffer_id < buffer_count; ++buffer_id) {
+            Buffer& buffer = *buffers_.emplace_back(new Buffer(buffer_size_));
+            buffer.attach_pool(*this, static_cast<uint32_t>(buffer_id));
+            provide(buffer);
+        }
+    }
+
+    BufferRing::~BufferRing() {
+        for (size_t buffer_id = 0; buffer_id < buffers_.size(); ++buffer_id) {
+            Buffer* buffer = buffers_[buffer_id];
+
+            if (selected_[buffer_id]) {
+                // Still referenced by the application. It will be deleted when it is finalized.
+                buffer->detach_pool();
+            }
+            else {
+                delete buffer;
+            }
+        }
+
+        io_uring_free_buf_ring(&ring_, buf_ring_, static_cast<unsigned>(buffers_.size()), group_id_);
+    }
+
+    auto BufferRing::group_id() const -> GroupId {
+        return group_id_;
+    }
+
+    size_t BufferRing::buffer_count() const {
+        return buffers_.size();
+    }
+
+    size_t BufferRing::buffer_size() const {
+        return buffer_size_;
+    }
+
+    size_t BufferRing::available_count() const {
+        return buffers_.size() - selected_count_;
+    }
+
+    Ref<Buffer> BufferRing::select(const uint16_t buffer_id) {
+        assert(buffer_id < buffers_.size());
+        assert(!selected_[buffer_id]);
+
+        selected_[buffer_id] = true;
+        selected_count_ += 1;
+        return bind(*buffers_[buffer_id]);
+    }
+
+    void BufferRing::reclaim(Buffer& buffer) {
+        assert(buffer.pool() == this);
+        assert(selected_[buffer.pool_index()]);
+
+        selected_[buffer.pool_index()] = false;
+        selected_count_ -= 1;
+        provide(buffer);
+    }
+
+    void BufferRing::provide(Buffer& buffer) {
+        std::span<std::byte> storage = buffer.storage();
+
+        io_uring_buf_ring_add(
+            buf_ring_,
+            storage.data(),
+            static_cast<unsigned>(storage.size()),
+            static_cast<unsigned short>(buffer.pool_index()),
+            io_uring_buf_ring_mask(static_cast<uint32_t>(selected_.size())),
+            0
+        );
+
+        io_uring_buf_ring_advance(buf_ring_, 1);
+    }
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <liburing.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "slag/object.h"
+#include "slag/memory/buffer.h"
+
+namespace slag {
+
+    // A pool of equally sized buffers that is shared with the kernel through a provided
+    // buffer ring. Operations that select from this group are handed a buffer by the kernel
+    // when data arrives, and the buffer is returned to the ring when it is finalized.
+    class BufferRing final : public BufferPool {
+    public:
+        using GroupId = uint16_t;
+
+        BufferRing(struct io_uring& ring, GroupId group_id, size_t buffer_count, size_t buffer_size);
+        ~BufferRing();
+
+        BufferRing(BufferRing&&) = delete;
+        BufferRing(const BufferRing&) = delete;
+        BufferRing& operator=(BufferRing&&) = delete;
+        BufferRing& operator=(const BufferRing&) = delete;
+
+        GroupId group_id() const;
+        size_t buffer_count() const;
+        size_t buffer_size() const;
+
+        // The buffers that the kernel can currently select from.
+        size_t available_count() const;
+
+        // Takes ownership of the buffer the kernel selected for a completion.
+        Ref<Buffer> select(uint16_t buffer_id);
+
+        void reclaim(Buffer& buffer) override;
+
+    private:
+        void provide(Buffer& buffer);
+
+    private:
+        struct io_uring&          ring_;
+        struct io_uring_buf_ring* buf_ring_;
+        GroupId                   group_id_;
+        size_t                    buffer_size_;
+        std::vector<Buffer*>      buffers_;
+        std::vector<bool>         selected_;
+        size_t                    selected_count_;
+    };
+
+}
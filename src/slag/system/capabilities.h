@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string_view>
+#include <bitset>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+
+// Optional io_uring features that the reactor probes for when it is created. Most of them
+// can't be probed directly, so they are inferred from an opcode added in the same release.
+#define SLAG_CAPABILITIES(X) \
+    X(FIXED_FILES)           \
+    X(BUFFER_RING)           \
+    X(MULTISHOT_ACCEPT)      \
+    X(MULTISHOT_RECV)        \
+    X(SEND_ZERO_COPY)        \
+    X(MSG_RING)              \
+    X(FILE_TRANSFER)         \
+    X(DIRECT_ACCEPT)         \
+    X(CANCEL_FD)             \
+    X(CANCEL_FD_FIXED)       \
+    X(SPLICE)                \
+
+namespace slag {
+
+    enum class Capability : uint8_t {
+#define X(SLAG_CAPABILITY) \
+        SLAG_CAPABILITY,   \
+
+        SLAG_CAPABILITIES(X)
+#undef X
+    };
+
+    constexpr size_t CAPABILITY_COUNT = 0
+#define X(SLAG_CAPABILITY) + 1
+        SLAG_CAPABILITIES(X)
+#undef X
+    ;
+
+    constexpr size_t to_index(Capability capability) {
+        return static_cast<size_t>(capability);
+    }
+
+    constexpr std::string_view to_string_view(Capability capability) {
+        using namespace std::literals;
+
+        switch (capability) {
+#define X(SLAG_CAPABILITY)                       \
+            case Capability::SLAG_CAPABILITY: {  \
+                return #SLAG_CAPABILITY##sv;     \
+            }                                    \
+
+            SLAG_CAPABILITIES(X)
+#undef X
+        }
+
+        abort();
+    }
+
+    class CapabilitySet {
+    public:
+        bool has(Capability capability) const {
+            return bits_.test(to_index(capability));
+        }
+
+        void set(Capability capability, bool value = true) {
+            bits_.set(to_index(capability), value);
+        }
+
+    private:
+        std::bitset<CAPABILITY_COUNT> bits_;
+    };
+
+}
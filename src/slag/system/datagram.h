@@ -0,0 +1,32 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <cstring>
+#include "slag/memory/buffer.h"
+
+namespace slag {
+
+    // A message and its peer address: the source when received, or the destination when sent.
+    struct Datagram {
+        struct sockaddr_storage address;
+        socklen_t               address_length;
+        BufferSlice             payload;
+
+        explicit Datagram(BufferSlice payload)
+            : address_length(0)
+            , payload(std::move(payload))
+        {
+            memset(&address, 0, sizeof(address));
+        }
+
+        Datagram(const struct sockaddr& address, socklen_t address_length, BufferSlice payload)
+            : Datagram(std::move(payload))
+        {
+            assert(address_length <= sizeof(this->address));
+
+            memcpy(&this->address, &address, address_length);
+            this->address_length = address_length;
+        }
+    };
+
+}
@@ -1,11 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <optional>
 #include <utility>
 #include <unistd.h>
+#include <liburing.h>
 #include "slag/core.h"
+#include "slag/system/file_table.h"
 
 namespace slag {
 
+    // Passed as the offset to read or write at the file's current position (and advance it).
+    constexpr uint64_t CURRENT_FILE_POSITION = static_cast<uint64_t>(-1);
+
     template<>
     class Resource<ResourceType::FILE_DESCRIPTOR> : public Object {
     public:
@@ -17,6 +24,9 @@ namespace slag {
         explicit Resource(int file_descriptor, Ownership ownership = Ownership::OWNED)
             : Object(static_cast<ObjectGroup>(ResourceType::FILE_DESCRIPTOR))
             , file_descriptor_(file_descriptor)
+            , submitted_(false)
+            , cancel_generation_(0)
+            , canceled_generation_(0)
         {
             switch (ownership) {
                 case Ownership::OWNED: {
@@ -35,7 +45,7 @@ namespace slag {
         }
 
         explicit operator bool() const {
-            return file_descriptor_ >= 0;
+            return (file_descriptor_ >= 0) || fixed_file_index_;
         }
 
         [[nodiscard]]
@@ -61,6 +71,63 @@ namespace slag {
             return file_descriptor_;
         }
 
+        // Files registered with the reactor (or created as direct descriptors) are also
+        // addressable by their slot in the ring's fixed file table.
+        bool is_fixed() const {
+            return static_cast<bool>(fixed_file_index_);
+        }
+
+        std::optional<FixedFileIndex> fixed_file_index() const {
+            return fixed_file_index_;
+        }
+
+        void attach_fixed_file(FixedFileIndex index) {
+            assert(!fixed_file_index_);
+            fixed_file_index_ = index;
+        }
+
+        [[nodiscard]]
+        std::optional<FixedFileIndex> detach_fixed_file() {
+            return std::exchange(fixed_file_index_, std::nullopt);
+        }
+
+        // Set once an operation on it has been submitted, after which the reactor leaves its
+        // registration alone (so that one cancel covers every operation on it).
+        bool is_submitted() const {
+            return submitted_;
+        }
+
+        void mark_submitted() {
+            submitted_ = true;
+        }
+
+        // Points a prepared submission at the fixed file slot when there is one.
+        void prepare(struct io_uring_sqe& io_sqe) const {
+            if (fixed_file_index_) {
+                io_sqe.fd = static_cast<int>(*fixed_file_index_);
+                io_sqe.flags |= IOSQE_FIXED_FILE;
+            }
+        }
+
+        // Advanced whenever a cancel of every request on the file descriptor is submitted.
+        // Operations record this when they are submitted, and were covered once a cancel with
+        // a later generation succeeds.
+        uint32_t cancel_generation() const {
+            return cancel_generation_;
+        }
+
+        uint32_t advance_cancel_generation() {
+            return ++cancel_generation_;
+        }
+
+        uint32_t canceled_generation() const {
+            return canceled_generation_;
+        }
+
+        void complete_cancel_generation(uint32_t generation) {
+            canceled_generation_ = std::max(canceled_generation_, generation);
+        }
+
         // The reactor can 'crack' file descriptors to close them asynchronously.
         // Otherwise they will be automatically be closed synchronously.
         [[nodiscard]]
@@ -76,7 +143,11 @@ namespace slag {
         }
 
     private:
-        int file_descriptor_;
+        int                           file_descriptor_;
+        std::optional<FixedFileIndex> fixed_file_index_;
+        bool                          submitted_;
+        uint32_t                      cancel_generation_;
+        uint32_t                      canceled_generation_;
     };
 
     template<typename... Args>
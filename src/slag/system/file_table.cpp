@@ -0,0 +1,41 @@
+#include "file_table.h"
+#include <cassert>
+
+namespace slag {
+
+    FileTable::FileTable(const size_t capacity)
+        : capacity_(capacity)
+        , free_indices_(capacity)
+    {
+        // Hand out low indices first.
+        for (size_t i = 0; i < free_indices_.size(); ++i) {
+            free_indices_[i] = static_cast<Index>(capacity_ - i - 1);
+        }
+    }
+
+    size_t FileTable::capacity() const {
+        return capacity_;
+    }
+
+    size_t FileTable::size() const {
+        return capacity_ - free_indices_.size();
+    }
+
+    auto FileTable::allocate() -> std::optional<Index> {
+        if (free_indices_.empty()) {
+            return std::nullopt;
+        }
+
+        const Index index = free_indices_.back();
+        free_indices_.pop_back();
+        return index;
+    }
+
+    void FileTable::deallocate(const Index index) {
+        assert(index < capacity_);
+        assert(free_indices_.size() < capacity_);
+
+        free_indices_.push_back(index);
+    }
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace slag {
+
+    // Bookkeeping for the slots of a ring's registered (fixed) file table. The reactor
+    // owns the actual registration; this just hands out and reclaims slot indices.
+    class FileTable {
+    public:
+        using Index = uint32_t;
+
+        explicit FileTable(size_t capacity = 0);
+
+        size_t capacity() const;
+        size_t size() const;
+
+        std::optional<Index> allocate();
+        void deallocate(Index index);
+
+    private:
+        size_t             capacity_;
+        std::vector<Index> free_indices_;
+    };
+
+    using FixedFileIndex = FileTable::Index;
+
+}
@@ -0,0 +1,104 @@
+#include "fixed_buffer_pool.h"
+#include <sys/uio.h>
+#include <stdexcept>
+#include <cstring>
+#include <cassert>
+
+namespace slag {
+
+    FixedBufferPool::FixedBufferPool(struct io_uring& ring, const size_t buffer_count, const size_t buffer_size)
+        : ring_(ring)
+        , buffer_size_(buffer_size)
+    {
+        if ((buffer_count == 0) || (buffer_count > MAX_BUFFER_COUNT)) {
+            throw std::runtime_error("Invalid fixed buffer pool size");
+        }
+
+        buffers_.reserve(buffer_count);
+        free_indices_.reserve(buffer_count);
+
+        std::vector<struct iovec> iovecs;
+        iovecs.reserve(buffer_count);
+
+        for (size_t index = 0; index < buffer_count; ++index) {
+            Buffer& buffer = *buffers_.emplace_back(new Buffer(buffer_size_));
+            buffer.attach_pool(*this, static_cast<uint32_t>(index));
+
+            // Hand out low indices first.
+            free_indices_.push_back(static_cast<uint32_t>(buffer_count - index - 1));
+
+            std::span<std::byte> storage = buffer.storage();
+            iovecs.push_back({
+                .iov_base = storage.data(),
+                .iov_len  = storage.size(),
+            });
+        }
+
+        int result = io_uring_register_buffers(&ring_, iovecs.data(), static_cast<unsigned>(iovecs.size()));
+        if (result < 0) {
+            for (Buffer* buffer: buffers_) {
+                delete buffer;
+            }
+
+            throw std::runtime_error(strerror(-result));
+        }
+    }
+
+    FixedBufferPool::~FixedBufferPool() {
+        std::vector<bool> available(buffers_.size(), false);
+        for (uint32_t index: free_indices_) {
+            available[index] = true;
+        }
+
+        for (size_t index = 0; index < buffers_.size(); ++index) {
+            Buffer* buffer = buffers_[index];
+
+            if (available[index]) {
+                delete buffer;
+            }
+            else {
+                // Still referenced by the application. It will be deleted when it is finalized.
+                buffer->detach_pool();
+            }
+        }
+
+        // The reactor drains what it has in flight first, so no fixed reads or writes use these.
+        io_uring_unregister_buffers(&ring_);
+    }
+
+    size_t FixedBufferPool::buffer_count() const {
+        return buffers_.size();
+    }
+
+    size_t FixedBufferPool::buffer_size() const {
+        return buffer_size_;
+    }
+
+    size_t FixedBufferPool::available_count() const {
+        return free_indices_.size();
+    }
+
+    Ptr<Buffer> FixedBufferPool::allocate() {
+        if (free_indices_.empty()) {
+            return {};
+        }
+
+        const uint32_t index = free_indices_.back();
+        free_indices_.pop_back();
+        return bind(*buffers_[index]);
+    }
+
+    void FixedBufferPool::reclaim(Buffer& buffer) {
+        assert(buffer.pool() == this);
+        assert(free_indices_.size() < buffers_.size());
+
+        free_indices_.push_back(buffer.pool_index());
+    }
+
+    std::optional<uint16_t> FixedBufferPool::registered_index(const Buffer& buffer) const {
+        assert(buffer.pool() == this);
+
+        return static_cast<uint16_t>(buffer.pool_index());
+    }
+
+}
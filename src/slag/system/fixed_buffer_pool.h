@@ -0,0 +1,45 @@
+#pragma once
+
+#include <liburing.h>
+#include <optional>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "slag/object.h"
+#include "slag/memory/buffer.h"
+
+namespace slag {
+
+    // A pool of equally sized buffers that are registered with the ring, so that reads and
+    // writes into them skip pinning and mapping the pages on every request.
+    class FixedBufferPool final : public BufferPool {
+    public:
+        // Buffer indices are 16 bits in submissions.
+        static constexpr size_t MAX_BUFFER_COUNT = 1ull << 16;
+
+        FixedBufferPool(struct io_uring& ring, size_t buffer_count, size_t buffer_size);
+        ~FixedBufferPool();
+
+        FixedBufferPool(FixedBufferPool&&) = delete;
+        FixedBufferPool(const FixedBufferPool&) = delete;
+        FixedBufferPool& operator=(FixedBufferPool&&) = delete;
+        FixedBufferPool& operator=(const FixedBufferPool&) = delete;
+
+        size_t buffer_count() const;
+        size_t buffer_size() const;
+        size_t available_count() const;
+
+        // Returns null if every buffer is in use.
+        Ptr<Buffer> allocate();
+
+        void reclaim(Buffer& buffer) override;
+        std::optional<uint16_t> registered_index(const Buffer& buffer) const override;
+
+    private:
+        struct io_uring&      ring_;
+        size_t                buffer_size_;
+        std::vector<Buffer*>  buffers_;
+        std::vector<uint32_t> free_indices_;
+    };
+
+}
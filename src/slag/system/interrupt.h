@@ -22,6 +22,7 @@ namespace slag {
 
     // An invalid operation key is used to distinguish an interrupt from a normal operation.
     constexpr OperationKey INTERRUPT_OPERATION_KEY;
+    static_assert(INTERRUPT_OPERATION_KEY.is_reserved());
 
     enum class InterruptReason : uint16_t {
 #define X(SLAG_INTERRUPT_REASON) \
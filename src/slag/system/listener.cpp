@@ -0,0 +1,68 @@
+#include "listener.h"
+#include "slag/system/operation_factory.h"
+
+namespace slag {
+
+    Listener::Listener(Ref<FileDescriptor> socket, const bool direct)
+        : socket_(std::move(socket))
+        , direct_(direct)
+        , accept_(start_accept_multishot_operation(socket_, direct_))
+        , error_(0)
+    {
+        accept_selector_.insert(accept_->readable_event());
+    }
+
+    Listener::~Listener() {
+        accept_selector_.remove(accept_->readable_event());
+        accept_->cancel();
+    }
+
+    Event& Listener::readable_event() {
+        return accept_selector_.readable_event();
+    }
+
+    Ptr<FileDescriptor> Listener::accept() {
+        if (Ptr<FileDescriptor> connection = accept_->accept()) {
+            return connection;
+        }
+
+        // The kernel ends multishot accepts on errors, and when the completion queue overflows.
+        // Rearm unless the socket itself is broken, in which case we stay readable.
+        if (accept_->is_complete() && !error_) {
+            if (is_permanent_error(accept_->result())) {
+                error_ = accept_->result();
+            }
+            else {
+                rearm();
+            }
+        }
+
+        return {};
+    }
+
+    void Listener::rearm() {
+        accept_selector_.remove(accept_->readable_event());
+        accept_ = start_accept_multishot_operation(socket_, direct_);
+        accept_selector_.insert(accept_->readable_event());
+    }
+
+    int32_t Listener::error() const {
+        return error_;
+    }
+
+    bool Listener::is_permanent_error(const int32_t result) {
+        switch (result) {
+            case -EBADF:
+            case -EINVAL:
+            case -ENOTSOCK:
+            case -EOPNOTSUPP:
+            case -ECANCELED: {
+                return true;
+            }
+            default: {
+                return false; // Running out of descriptors or memory, aborted connections, etc.
+            }
+        }
+    }
+
+}
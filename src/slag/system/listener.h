@@ -0,0 +1,47 @@
+#pragma once
+
+#include "slag/core.h"
+#include "slag/object.h"
+#include "slag/resource.h"
+#include "slag/core/selector.h"
+#include "slag/system/file_descriptor.h"
+#include "slag/system/operations/accept_multishot_operation.h"
+
+namespace slag {
+
+    // Accepts connections on a listening socket. It is readable when a connection can be
+    // accepted, and keeps a multishot accept armed until the socket fails permanently.
+    // Direct connections skip the process file table and are only usable through the ring,
+    // when the kernel supports it.
+    class Listener final : public Pollable<PollableType::READABLE> {
+    public:
+        explicit Listener(Ref<FileDescriptor> socket, bool direct = false);
+        ~Listener();
+
+        Listener(Listener&&) = delete;
+        Listener(const Listener&) = delete;
+        Listener& operator=(Listener&&) = delete;
+        Listener& operator=(const Listener&) = delete;
+
+        Event& readable_event() override;
+
+        // Returns the next connection, if there is one.
+        Ptr<FileDescriptor> accept();
+
+        // The error that stopped the listener, or zero.
+        int32_t error() const;
+
+    private:
+        void rearm();
+
+        static bool is_permanent_error(int32_t result);
+
+    private:
+        Ref<FileDescriptor>           socket_;
+        bool                          direct_;
+        Ref<AcceptMultishotOperation> accept_;
+        Selector                      accept_selector_; // Mirrors the current accept, which is replaced on rearm.
+        int32_t                       error_;
+    };
+
+}
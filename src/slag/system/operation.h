@@ -1,9 +1,15 @@
 #pragma once
 
 #include <liburing.h>
+#include <chrono>
+#include <optional>
+#include <span>
+#include <type_traits>
 #include "slag/core.h"
+#include "slag/resource.h"
+#include "file_descriptor.h"
 #include "operation_types.h"
-#include "operation_table.h"
+#include "operation_key.h"
 
 namespace slag {
 
@@ -15,8 +21,40 @@ namespace slag {
         COMPLETE,          // The operation has completed.
     };
 
+    // Pending operations are submitted in priority order.
+    enum class OperationPriority : uint8_t {
+        HIGH,   // Latency sensitive (e.g. network sends).
+        NORMAL,
+        LOW,    // Bulk work that can wait (e.g. large disk writes).
+    };
+
+    constexpr size_t OPERATION_PRIORITY_COUNT = 3;
+
+    constexpr size_t to_index(OperationPriority priority) {
+        return static_cast<size_t>(priority);
+    }
+
+    // Linked timeouts are not tracked by the reactor. Their completions are ignored,
+    // since the operation they are attached to reports the outcome.
+    constexpr OperationKey LINK_TIMEOUT_OPERATION_KEY{0xFFFF'FFFE'FFFF'FFFFull};
+    static_assert(LINK_TIMEOUT_OPERATION_KEY.is_reserved());
+
+    // Operations are aligned so that keys which point at them have room for a generation tag.
+    constexpr size_t OPERATION_KEY_TAG_BITS = 4;
+    constexpr size_t OPERATION_ALIGNMENT    = 1ull << OPERATION_KEY_TAG_BITS;
+
+    // Converts a steady clock time point to an absolute CLOCK_MONOTONIC timespec.
+    inline struct __kernel_timespec to_kernel_timespec(const std::chrono::steady_clock::time_point time_point) {
+        const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(time_point.time_since_epoch());
+
+        struct __kernel_timespec timespec;
+        timespec.tv_sec = nanoseconds.count() / 1'000'000'000;
+        timespec.tv_nsec = nanoseconds.count() % 1'000'000'000;
+        return timespec;
+    }
+
     template<>
-    class Resource<ResourceType::OPERATION> 
+    class alignas(OPERATION_ALIGNMENT) Resource<ResourceType::OPERATION>
         : public Object
         , public Pollable<PollableType::WRITABLE> // Ready when the operation can be submitted. Used internally.
         , public Pollable<PollableType::READABLE> // Ready when the result is partially or fully available.
@@ -29,10 +67,22 @@ namespace slag {
             , state_(OperationState::OPERATION_PENDING)
             , abandoned_(false)
             , daemonized_(false)
+            , priority_(OperationPriority::NORMAL)
+            , key_generation_(0)
+            , target_(nullptr)
+            , target_cancel_generation_(0)
         {
             writable_event_.set();
         }
 
+        // Operations on a single file descriptor can be canceled along with everything else on it.
+        // The implementation has to keep the file descriptor alive.
+        Resource(const OperationType operation_type, FileDescriptor& target)
+            : Resource(operation_type)
+        {
+            target_ = &target;
+        }
+
         virtual ~Resource() = default;
 
         OperationType type() const {
@@ -43,10 +93,20 @@ namespace slag {
             return state_;
         }
 
+        // The file descriptor the operation works on, if it is limited to one.
+        FileDescriptor* target() const {
+            return target_;
+        }
+
         bool is_quiescent() const {
             return !key_ && !cancel_key_;
         }
 
+        // The key of the submission in flight, if any.
+        OperationKey key() const {
+            return key_;
+        }
+
         bool is_abandoned() const {
             return abandoned_;
         }
@@ -55,6 +115,15 @@ namespace slag {
             abandoned_ = true;
         }
 
+        OperationPriority priority() const {
+            return priority_;
+        }
+
+        // Takes effect the next time the operation is scheduled, so set it before starting it.
+        void set_priority(OperationPriority priority) {
+            priority_ = priority;
+        }
+
         bool is_daemonized() const {
             return daemonized_;
         }
@@ -63,6 +132,23 @@ namespace slag {
             daemonized_ = true;
         }
 
+        // The kernel cancels the operation if it is still running at the deadline, and it
+        // completes with -ECANCELED. This has to be set before the operation is submitted.
+        void set_deadline(const std::chrono::steady_clock::time_point deadline) {
+            assert(state_ == OperationState::OPERATION_PENDING);
+
+            deadline_ = to_kernel_timespec(deadline);
+        }
+
+        template<typename Rep, typename Period>
+        void set_timeout(const std::chrono::duration<Rep, Period>& timeout) {
+            set_deadline(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout));
+        }
+
+        bool has_deadline() const {
+            return deadline_.has_value();
+        }
+
         Event& writable_event() override {
             return writable_event_;
         }
@@ -79,11 +165,18 @@ namespace slag {
             switch (state_) {
                 case OperationState::OPERATION_PENDING: {
                     // The operation has not been submitted yet, and can be canceled immediately.
-                    constexpr bool more = false;
-                    handle_result(key_, -ECANCELED, more);
+                    constexpr uint32_t flags = 0;
+                    writable_event_.reset();
+                    handle_result(key_, -ECANCELED, flags);
                     break;
                 }
                 case OperationState::OPERATION_WORKING: {
+                    if (is_target_canceled()) {
+                        // The kernel is already canceling it. Wait for the operation to complete.
+                        state_ = OperationState::CANCEL_WORKING;
+                        break;
+                    }
+
                     state_ = OperationState::CANCEL_PENDING;
                     writable_event_.set();
                     break;
@@ -94,71 +187,194 @@ namespace slag {
             }
         }
 
+        // True if everything on the target file descriptor was canceled after this was submitted.
+        bool is_target_canceled() const {
+            return target_ && (target_cancel_generation_ < target_->canceled_generation());
+        }
+
+        // The number of submission queue entries the operation needs in its current state.
+        size_t entry_count() const {
+            return (state_ == OperationState::OPERATION_PENDING) ? operation_entry_count() : 1;
+        }
+
         void prepare(OperationKey op_key, struct io_uring_sqe& io_sqe) {
-            switch (state_) {
-                case OperationState::OPERATION_PENDING: {
-                    prepare_operation(io_sqe);
-                    key_ = op_key;
-                    break;
-                }
-                case OperationState::CANCEL_PENDING: {
-                    prepare_cancel(io_sqe);
-                    cancel_key_ = op_key;
-                    break;
-                }
-                default: {
-                    abort();
-                }
-            }
+            struct io_uring_sqe* io_sqes[] = {&io_sqe};
+            prepare(op_key, io_sqes);
+        }
 
-            writable_event_.reset();
+        // Every entry is submitted under the same key.
+        void prepare(OperationKey op_key, std::span<struct io_uring_sqe* const> io_sqes) {
+            prepare_as<Operation>(op_key, io_sqes);
         }
 
-        void handle_result(OperationKey op_key, int32_t result, bool more) {
-            if (key_ == op_key) {
-                if (!more) {
-                    key_ = OperationKey{};
-                }
+        // Like `prepare`, but calls the hooks of the implementing (final) class directly so that
+        // they can be inlined. The reactor switches on the type to pick the class.
+        template<typename OperationImpl>
+        void prepare_as(OperationKey op_key, std::span<struct io_uring_sqe* const> io_sqes);
 
-                handle_operation_result(result, more);
-            }
-            else if (cancel_key_ == op_key) {
-                if (!more) {
-                    cancel_key_ = OperationKey{};
-                }
+        // Advanced for each submission, so that keys which point directly at the operation
+        // can be told apart. The reactor carries it over when the storage is reused by another
+        // operation, so that keys for the previous one don't match either.
+        uint8_t key_generation() const {
+            return key_generation_;
+        }
 
-                handle_cancel_result(result, more);
-            }
-            else {
-                abort();
-            }
+        void set_key_generation(uint8_t key_generation) {
+            key_generation_ = key_generation;
+        }
 
-            if (is_quiescent()) {
-                state_ = OperationState::COMPLETE;
-                complete_event_.set();
-            }
+        uint8_t advance_key_generation() {
+            return ++key_generation_;
+        }
+
+        // True while completions are still expected for the key.
+        bool uses_key(OperationKey op_key) const {
+            return op_key && ((key_ == op_key) || (cancel_key_ == op_key));
+        }
+
+        // Prepares the linked timeout that follows the operation's own submission.
+        void prepare_deadline(struct io_uring_sqe& io_sqe) {
+            assert(deadline_);
+
+            io_uring_prep_link_timeout(&io_sqe, &*deadline_, IORING_TIMEOUT_ABS);
+        }
+
+        void handle_result(OperationKey op_key, int32_t result, uint32_t flags) {
+            handle_result_as<Operation>(op_key, result, flags);
+        }
+
+        template<typename OperationImpl>
+        void handle_result_as(OperationKey op_key, int32_t result, uint32_t flags);
+
+    protected:
+        // Returns a completed operation to the pending state, and submits it again. The reactor
+        // keeps its writable event attached after it is prepared (for cancels), so setting it
+        // schedules the operation; it must not be scheduled explicitly.
+        // The implementation resets its own results.
+        void reset() {
+            assert(state_ == OperationState::COMPLETE);
+            assert(is_quiescent());
+
+            state_ = OperationState::OPERATION_PENDING;
+            readable_event_.reset();
+            complete_event_.reset();
+            writable_event_.set();
         }
 
-    private:
         virtual void prepare_operation(struct io_uring_sqe& io_sqe) = 0;
 
+        // Batched operations submit several entries at once, and complete after the last of them.
+        virtual size_t operation_entry_count() const {
+            return 1;
+        }
+
+        virtual void prepare_operation_batch(std::span<struct io_uring_sqe* const> io_sqes) {
+            (void)io_sqes;
+            abort();
+        }
+
         virtual void prepare_cancel(struct io_uring_sqe& io_sqe) {
             io_uring_prep_cancel64(&io_sqe, encode_operation_key(key_), 0);
         }
 
-        virtual void handle_operation_result(int32_t result, bool more) = 0;
+    private:
+        // The completion flags carry extra information for some operations (selected buffer, etc.).
+        virtual void handle_operation_result(int32_t result, bool more, uint32_t flags) = 0;
         virtual void handle_cancel_result(int32_t result, bool more) = 0;
 
     private:
-        OperationType  type_;
-        OperationState state_;
-        bool           abandoned_;
-        bool           daemonized_;
-        OperationKey   key_;
-        OperationKey   cancel_key_;
-        Event          writable_event_;
-        Event          readable_event_;
-        Event          complete_event_;
+        OperationType     type_;
+        OperationState    state_;
+        bool              abandoned_;
+        bool              daemonized_;
+        OperationPriority priority_;
+        uint8_t           key_generation_;
+        FileDescriptor*   target_;
+        uint32_t          target_cancel_generation_;
+        OperationKey      key_;
+        OperationKey      cancel_key_;
+        uint32_t          outstanding_entry_count_ = 0;
+        Event             writable_event_;
+        Event             readable_event_;
+        Event             complete_event_;
+
+        // Kept here since the kernel reads it when the submission is consumed.
+        std::optional<struct __kernel_timespec> deadline_;
     };
 
+    template<typename OperationImpl>
+    inline void Operation::prepare_as(OperationKey op_key, std::span<struct io_uring_sqe* const> io_sqes) {
+        static_assert(std::is_same_v<OperationImpl, Operation> || std::is_final_v<OperationImpl>);
+        OperationImpl& impl = static_cast<OperationImpl&>(*this);
+
+        assert(io_sqes.size() == entry_count());
+
+        switch (state_) {
+            case OperationState::OPERATION_PENDING: {
+                if (io_sqes.size() == 1) {
+                    impl.prepare_operation(*io_sqes[0]);
+                }
+                else {
+                    impl.prepare_operation_batch(io_sqes);
+                }
+
+                state_ = OperationState::OPERATION_WORKING;
+                key_ = op_key;
+                if (target_) {
+                    target_cancel_generation_ = target_->cancel_generation();
+                }
+                outstanding_entry_count_ = static_cast<uint32_t>(io_sqes.size());
+                break;
+            }
+            case OperationState::CANCEL_PENDING: {
+                impl.prepare_cancel(*io_sqes[0]);
+                state_ = OperationState::CANCEL_WORKING;
+                cancel_key_ = op_key;
+                break;
+            }
+            default: {
+                abort();
+            }
+        }
+
+        writable_event_.reset();
+    }
+
+    template<typename OperationImpl>
+    inline void Operation::handle_result_as(OperationKey op_key, int32_t result, uint32_t flags) {
+        static_assert(std::is_same_v<OperationImpl, Operation> || std::is_final_v<OperationImpl>);
+        OperationImpl& impl = static_cast<OperationImpl&>(*this);
+
+        const bool more = flags & IORING_CQE_F_MORE;
+
+        if (key_ == op_key) {
+            if (!more) {
+                // Batches receive a final completion for each entry.
+                if (outstanding_entry_count_ > 0) {
+                    --outstanding_entry_count_;
+                }
+                if (outstanding_entry_count_ == 0) {
+                    key_ = OperationKey{};
+                }
+            }
+
+            impl.handle_operation_result(result, more, flags);
+        }
+        else if (cancel_key_ == op_key) {
+            if (!more) {
+                cancel_key_ = OperationKey{};
+            }
+
+            impl.handle_cancel_result(result, more);
+        }
+        else {
+            abort();
+        }
+
+        if (is_quiescent()) {
+            state_ = OperationState::COMPLETE;
+            complete_event_.set();
+        }
+    }
+
 }
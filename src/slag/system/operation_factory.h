@@ -1,12 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <span>
+#include <vector>
 #include "slag/context.h"
 #include "slag/object.h"
 #include "reactor.h"
-#include "operations/nop_operation.h"
-#include "operations/close_operation.h"
-#include "operations/poll_multishot_operation.h"
-#include "operations/interrupt_operation.h"
+#include "operations.h"
 
 namespace slag {
 
@@ -37,6 +37,202 @@ namespace slag {
         return op;
     }
 
+    // Falls back to single-shot receives on kernels without multishot receive.
+    inline Ref<ReceiveMultishotOperation> start_receive_multishot_operation(const Ref<FileDescriptor>& file_descriptor, BufferRing& buffer_ring) {
+        Reactor& reactor = get_reactor();
+
+        const bool multishot = reactor.has_capability(Capability::MULTISHOT_RECV);
+        auto op = reactor.create_operation<ReceiveMultishotOperation>(file_descriptor, buffer_ring, multishot);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    template<typename... Args>
+    inline Ref<TimerOperation> start_timer_operation(Args&&... args) {
+        Reactor& reactor = get_reactor();
+
+        auto op = reactor.create_operation<TimerOperation>(std::forward<Args>(args)...);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    template<typename... Args>
+    inline Ref<SocketOperation> start_socket_operation(Args&&... args) {
+        Reactor& reactor = get_reactor();
+
+        auto op = reactor.create_operation<SocketOperation>(std::forward<Args>(args)...);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    template<typename... Args>
+    inline Ref<ConnectOperation> start_connect_operation(Args&&... args) {
+        Reactor& reactor = get_reactor();
+
+        auto op = reactor.create_operation<ConnectOperation>(std::forward<Args>(args)...);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    // Falls back to single-shot accepts on kernels without multishot accept. Direct accepts fall
+    // back to plain descriptors when the ring has nowhere to put them.
+    inline Ref<AcceptMultishotOperation> start_accept_multishot_operation(const Ref<FileDescriptor>& file_descriptor, bool direct = false) {
+        Reactor& reactor = get_reactor();
+
+        const bool multishot = reactor.has_capability(Capability::MULTISHOT_ACCEPT);
+        direct = direct && reactor.has_capability(Capability::DIRECT_ACCEPT);
+        auto op = reactor.create_operation<AcceptMultishotOperation>(file_descriptor, multishot, direct);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    // Falls back to a plain send on kernels without zero copy sends.
+    inline Ref<SendZeroCopyOperation> start_send_zero_copy_operation(const Ref<FileDescriptor>& file_descriptor, BufferSlice slice, int flags = MSG_NOSIGNAL) {
+        Reactor& reactor = get_reactor();
+
+        const bool zero_copy = reactor.has_capability(Capability::SEND_ZERO_COPY);
+        auto op = reactor.create_operation<SendZeroCopyOperation>(file_descriptor, std::move(slice), flags, zero_copy);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    template<typename... Args>
+    inline Ref<ReadOperation> start_read_operation(Args&&... args) {
+        Reactor& reactor = get_reactor();
+
+        auto op = reactor.create_operation<ReadOperation>(std::forward<Args>(args)...);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    template<typename... Args>
+    inline Ref<WriteOperation> start_write_operation(Args&&... args) {
+        Reactor& reactor = get_reactor();
+
+        auto op = reactor.create_operation<WriteOperation>(std::forward<Args>(args)...);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    template<typename... Args>
+    inline Ref<ReadvOperation> start_readv_operation(Args&&... args) {
+        Reactor& reactor = get_reactor();
+
+        auto op = reactor.create_operation<ReadvOperation>(std::forward<Args>(args)...);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    template<typename... Args>
+    inline Ref<WritevOperation> start_writev_operation(Args&&... args) {
+        Reactor& reactor = get_reactor();
+
+        auto op = reactor.create_operation<WritevOperation>(std::forward<Args>(args)...);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    // Falls back to single-shot receives on kernels without multishot receive.
+    inline Ref<ReceiveMessageMultishotOperation> start_receive_message_multishot_operation(const Ref<FileDescriptor>& file_descriptor, BufferRing& buffer_ring) {
+        Reactor& reactor = get_reactor();
+
+        const bool multishot = reactor.has_capability(Capability::MULTISHOT_RECV);
+        auto op = reactor.create_operation<ReceiveMessageMultishotOperation>(file_descriptor, buffer_ring, multishot);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    // Queues as many datagrams from the front as can be submitted together (leaving room for a
+    // deadline). The caller's datagrams are left alone; the operation's `datagram_count` says
+    // how many were queued, and the rest have to be sent with another batch.
+    inline Ref<SendMessageBatchOperation> start_send_message_batch_operation(const Ref<FileDescriptor>& file_descriptor, std::span<const Datagram> datagrams, int flags = MSG_NOSIGNAL) {
+        Reactor& reactor = get_reactor();
+
+        const size_t batch_size = std::min(datagrams.size(), reactor.submission_queue_size() - 1);
+        std::vector<Datagram> batch(datagrams.begin(), datagrams.begin() + batch_size);
+
+        auto op = reactor.create_operation<SendMessageBatchOperation>(file_descriptor, std::move(batch), flags);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    template<typename... Args>
+    inline Ref<SpliceOperation> start_splice_operation(Args&&... args) {
+        Reactor& reactor = get_reactor();
+
+        auto op = reactor.create_operation<SpliceOperation>(std::forward<Args>(args)...);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    template<typename... Args>
+    inline Ref<TeeOperation> start_tee_operation(Args&&... args) {
+        Reactor& reactor = get_reactor();
+
+        auto op = reactor.create_operation<TeeOperation>(std::forward<Args>(args)...);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    // Completes with -EOPNOTSUPP on kernels that can't cancel by file descriptor. Fixed
+    // descriptors need a newer kernel (6.0) than regular ones (5.19).
+    inline Ref<CancelOperation> start_cancel_operation(const Ref<FileDescriptor>& file_descriptor) {
+        Reactor& reactor = get_reactor();
+
+        auto op = reactor.create_operation<CancelOperation>(file_descriptor);
+
+        const Capability capability = file_descriptor->fixed_file_index() ? Capability::CANCEL_FD_FIXED : Capability::CANCEL_FD;
+        if (!reactor.has_capability(capability)) {
+            // There is nothing to submit, so complete it here instead of spending an entry on it.
+            constexpr uint32_t flags = 0;
+            op->writable_event().reset();
+            op->handle_result(op->key(), -EOPNOTSUPP, flags);
+            return op;
+        }
+
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    template<typename... Args>
+    inline Ref<SendFileDescriptorOperation> start_send_file_descriptor_operation(Args&&... args) {
+        Reactor& reactor = get_reactor();
+
+        auto op = reactor.create_operation<SendFileDescriptorOperation>(std::forward<Args>(args)...);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    // Starts an operation that is submitted ahead of (or behind) normal ones.
+    template<typename OperationImpl, typename... Args>
+    inline Ref<OperationImpl> start_operation(OperationPriority priority, Args&&... args) {
+        Reactor& reactor = get_reactor();
+
+        auto op = reactor.create_operation<OperationImpl>(std::forward<Args>(args)...);
+        op->set_priority(priority);
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
+    // Creates an operation without starting it, to be used as a step of a linked operation.
+    template<typename OperationImpl, typename... Args>
+    inline Ref<OperationImpl> create_operation(Args&&... args) {
+        return get_reactor().create_operation<OperationImpl>(std::forward<Args>(args)...);
+    }
+
+    template<typename... OperationImpls>
+    inline Ref<LinkedOperation> start_linked_operation(const Ref<OperationImpls>&... steps) {
+        Reactor& reactor = get_reactor();
+
+        std::vector<Ref<Operation>> linked_steps;
+        linked_steps.reserve(sizeof...(steps));
+        (linked_steps.push_back(bind(static_cast<Operation&>(*steps))), ...);
+
+        auto op = reactor.create_operation<LinkedOperation>(std::move(linked_steps));
+        reactor.schedule_operation(*op);
+        return op;
+    }
+
     template<typename... Args>
     inline Ref<InterruptOperation> start_interrupt_operation(Args&&... args) {
         Reactor& reactor = get_reactor();
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+
+namespace slag {
+
+    // How the reactor encodes operation keys in `io_uring_sqe.user_data`.
+    enum class OperationKeyEncoding : uint8_t {
+        // An index into the reactor's operation table and a nonce to detect stale keys.
+        TABLE,
+
+        // The address of the operation, with a generation tag in the low bits that the
+        // operation validates. This keeps the table off of the completion path.
+        TAGGED_POINTER,
+    };
+
+    // An opaque key for a submitted operation. The value is what the kernel sees as user data.
+    //
+    // Reserved keys set the top 16 bits (never a user space address) and the low 32 bits
+    // (never a table index). The default key is reserved, and used for interrupts.
+    class OperationKey {
+    public:
+        static constexpr uint64_t INVALID_VALUE = ~0ull;
+
+        constexpr OperationKey()
+            : value_(INVALID_VALUE)
+        {
+        }
+
+        constexpr explicit OperationKey(uint64_t value)
+            : value_(value)
+        {
+        }
+
+        constexpr uint64_t value() const {
+            return value_;
+        }
+
+        constexpr bool is_reserved() const {
+            constexpr uint64_t reserved_mask = 0xFFFF'0000'FFFF'FFFFull;
+            return (value_ & reserved_mask) == reserved_mask;
+        }
+
+        explicit operator bool() const {
+            return value_ != INVALID_VALUE;
+        }
+
+        constexpr auto operator<=>(const OperationKey&) const = default;
+
+    private:
+        uint64_t value_;
+    };
+
+    inline uint64_t encode_operation_key(OperationKey decoded_key) {
+        return decoded_key.value();
+    }
+
+    inline OperationKey decode_operation_key(uint64_t encoded_key) {
+        return OperationKey(encoded_key);
+    }
+
+}
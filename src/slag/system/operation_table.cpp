@@ -12,7 +12,7 @@ namespace slag {
         }
     }
 
-    auto OperationTable::insert(Operation& operation) -> Key {
+    OperationKey OperationTable::insert(Operation& operation) {
         Index index;
         if (tombstones_.empty()) {
             index = static_cast<Index>(table_.size());
@@ -31,58 +31,54 @@ namespace slag {
         record.operation = &operation;
         record.nonce += 1;
 
-        return {
-            .index = index,
-            .nonce = record.nonce,
-        };
+        return make_key(index, record.nonce);
     }
 
-    Operation& OperationTable::select(const Key key) {
-        if (table_.size() <= key.index) {
-            abort();
-        }
-
-        Record& record = table_[key.index];
-        if (key.nonce != record.nonce) {
+    Operation& OperationTable::select(const OperationKey key) {
+        Record& record = lookup(key);
+        if (!record.operation) {
             abort();
         }
 
         return *record.operation;
     }
 
-    void OperationTable::remove(const Key key) {
-        if (table_.size() <= key.index) {
-            abort();
-        }
-
-        Record& record = table_[key.index];
-        if (key.nonce != record.nonce) {
+    void OperationTable::remove(const OperationKey key) {
+        Record& record = lookup(key);
+        if (!record.operation) {
             abort();
         }
 
         record.operation = nullptr;
+        tombstones_.push_back(key_index(key));
+    }
+
+    OperationKey OperationTable::make_key(const Index index, const Nonce nonce) {
+        assert(index != INVALID_INDEX);
+
+        return OperationKey((static_cast<uint64_t>(nonce) << 32) | index);
+    }
+
+    auto OperationTable::key_index(const OperationKey key) -> Index {
+        return static_cast<Index>(key.value());
     }
 
-    uint64_t encode_operation_key(OperationKey decoded_key) {
-        uint64_t encoded_key;
-        static_assert(sizeof(encoded_key) == sizeof(decoded_key));
-        memcpy(&encoded_key, &decoded_key, sizeof(encoded_key));
-        return encoded_key;
+    auto OperationTable::key_nonce(const OperationKey key) -> Nonce {
+        return static_cast<Nonce>(key.value() >> 32);
     }
 
-    OperationKey decode_operation_key(uint64_t encoded_key) {
-        struct {
-            uint32_t index;
-            uint32_t nonce;
-        } primitive_decoded_key;
+    auto OperationTable::lookup(const OperationKey key) -> Record& {
+        const Index index = key_index(key);
+        if (table_.size() <= index) {
+            abort();
+        }
 
-        static_assert(sizeof(primitive_decoded_key) == sizeof(encoded_key));
-        memcpy(&primitive_decoded_key, &encoded_key, sizeof(primitive_decoded_key));
+        Record& record = table_[index];
+        if (key_nonce(key) != record.nonce) {
+            abort();
+        }
 
-        OperationKey decoded_key;
-        decoded_key.index = primitive_decoded_key.index;
-        decoded_key.nonce = primitive_decoded_key.nonce;
-        return decoded_key;
+        return record;
     }
 
 }
@@ -2,9 +2,9 @@
 
 #include "slag/object.h"
 #include "slag/resource.h"
+#include "slag/system/operation_key.h"
 
 #include <stdexcept>
-#include <compare>
 #include <vector>
 #include <limits>
 #include <cstdlib>
@@ -21,17 +21,6 @@ namespace slag {
         static constexpr Index INVALID_INDEX = std::numeric_limits<Index>::max();
         static constexpr Nonce INVALID_NONCE = std::numeric_limits<Nonce>::max();
 
-        struct Key {
-            Index index = INVALID_INDEX;
-            Nonce nonce = INVALID_NONCE;
-
-            explicit operator bool() const {
-                return *this != Key{};
-            }
-
-            auto operator<=>(const Key&) const = default;
-        };
-
         struct Record {
             Operation* operation = nullptr;
             Nonce nonce = 0;
@@ -40,18 +29,21 @@ namespace slag {
     public:
         explicit OperationTable(size_t initial_capacity = 1024);
 
-        Key insert(Operation& operation);
-        Operation& select(Key key);
-        void remove(Key key);
+        OperationKey insert(Operation& operation);
+        Operation& select(OperationKey key);
+        void remove(OperationKey key);
+
+        // Keys hold the index in the low half, and the nonce in the high half.
+        static OperationKey make_key(Index index, Nonce nonce);
+        static Index key_index(OperationKey key);
+        static Nonce key_nonce(OperationKey key);
+
+    private:
+        Record& lookup(OperationKey key);
 
     private:
         std::vector<Record>   table_;
         std::vector<uint32_t> tombstones_;
     };
 
-    using OperationKey = OperationTable::Key;
-
-    uint64_t encode_operation_key(OperationKey decoded_key);
-    OperationKey decode_operation_key(uint64_t encoded_key);
-
 }
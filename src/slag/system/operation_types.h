@@ -6,34 +6,66 @@
 #include <cstdint>
 #include <cstddef>
 
-#define SLAG_OPERATION_TYPES(X) \
-    X(NOP)                      \
-    X(CLOSE)                    \
-    X(POLL_MULTISHOT)           \
-    X(INTERRUPT)                \
+// Each operation type and the class that implements it.
+#define SLAG_OPERATION_TYPES(X)                               \
+    X(NOP, NopOperation)                                      \
+    X(CLOSE, CloseOperation)                                  \
+    X(POLL_MULTISHOT, PollMultishotOperation)                 \
+    X(RECV_MULTISHOT, ReceiveMultishotOperation)              \
+    X(RECVMSG_MULTISHOT, ReceiveMessageMultishotOperation)    \
+    X(SENDMSG_BATCH, SendMessageBatchOperation)               \
+    X(LINKED, LinkedOperation)                                \
+    X(TIMER, TimerOperation)                                  \
+    X(SOCKET, SocketOperation)                                \
+    X(CONNECT, ConnectOperation)                              \
+    X(ACCEPT_MULTISHOT, AcceptMultishotOperation)             \
+    X(SEND_ZC, SendZeroCopyOperation)                         \
+    X(READ, ReadOperation)                                    \
+    X(WRITE, WriteOperation)                                  \
+    X(READV, ReadvOperation)                                  \
+    X(WRITEV, WritevOperation)                                \
+    X(SPLICE, SpliceOperation)                                \
+    X(TEE, TeeOperation)                                      \
+    X(CANCEL, CancelOperation)                                \
+    X(SEND_FD, SendFileDescriptorOperation)                   \
+    X(INTERRUPT, InterruptOperation)                          \
 
     // X(OPEN)
     // X(CLOSE)
-    // X(WRITE)
-    // X(TIMER)
-    // X(SOCKET)
-    // X(CONNECT)
-    // X(ACCEPT)
     // X(MADVISE)
     // X(INTERRUPT)
 
 namespace slag {
 
     enum class OperationType : uint8_t {
-#define X(SLAG_OPERATION_TYPE) \
-        SLAG_OPERATION_TYPE,   \
+#define X(SLAG_OPERATION_TYPE, SLAG_OPERATION_IMPL) \
+        SLAG_OPERATION_TYPE,                        \
 
         SLAG_OPERATION_TYPES(X)
 #undef X
     };
 
+#define X(SLAG_OPERATION_TYPE, SLAG_OPERATION_IMPL) \
+    class SLAG_OPERATION_IMPL;                      \
+
+    SLAG_OPERATION_TYPES(X)
+#undef X
+
+    // Maps an operation class to its type at compile time.
+    template<typename OperationImpl>
+    struct OperationTraits;
+
+#define X(SLAG_OPERATION_TYPE, SLAG_OPERATION_IMPL)                               \
+    template<>                                                                    \
+    struct OperationTraits<SLAG_OPERATION_IMPL> {                                 \
+        static constexpr OperationType TYPE = OperationType::SLAG_OPERATION_TYPE; \
+    };                                                                            \
+
+    SLAG_OPERATION_TYPES(X)
+#undef X
+
     constexpr size_t OPERATION_TYPE_COUNT = 0
-#define X(SLAG_OPERATION_TYPE) + 1
+#define X(SLAG_OPERATION_TYPE, SLAG_OPERATION_IMPL) + 1
         SLAG_OPERATION_TYPES(X)
 #undef X
     ;
@@ -46,7 +78,7 @@ namespace slag {
         using namespace std::literals;
 
         switch (operation_type) {
-#define X(SLAG_OPERATION_TYPE)                         \
+#define X(SLAG_OPERATION_TYPE, SLAG_OPERATION_IMPL)    \
             case OperationType::SLAG_OPERATION_TYPE: { \
                 return #SLAG_OPERATION_TYPE##sv;       \
             }                                          \
@@ -0,0 +1,24 @@
+#pragma once
+
+// Every operation named by SLAG_OPERATION_TYPES, for code that dispatches on the type.
+#include "operations/nop_operation.h"
+#include "operations/close_operation.h"
+#include "operations/poll_multishot_operation.h"
+#include "operations/receive_multishot_operation.h"
+#include "operations/receive_message_multishot_operation.h"
+#include "operations/send_message_batch_operation.h"
+#include "operations/linked_operation.h"
+#include "operations/timer_operation.h"
+#include "operations/socket_operation.h"
+#include "operations/connect_operation.h"
+#include "operations/accept_multishot_operation.h"
+#include "operations/send_zero_copy_operation.h"
+#include "operations/read_operation.h"
+#include "operations/write_operation.h"
+#include "operations/readv_operation.h"
+#include "operations/writev_operation.h"
+#include "operations/splice_operation.h"
+#include "operations/tee_operation.h"
+#include "operations/cancel_operation.h"
+#include "operations/send_file_descriptor_operation.h"
+#include "operations/interrupt_operation.h"
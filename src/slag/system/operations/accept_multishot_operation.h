@@ -0,0 +1,109 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <liburing.h>
+#include <algorithm>
+#include <deque>
+#include "slag/core.h"
+#include "slag/system/operation.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    // Accepts connections on a listening socket until the kernel terminates the operation.
+    // Without multishot support it accepts a single connection and completes with zero.
+    // Direct connections are installed straight into a fixed file slot that the kernel picks,
+    // and are only addressable through the ring.
+    class AcceptMultishotOperation final : public Operation {
+    public:
+        explicit AcceptMultishotOperation(const Ref<FileDescriptor>& file_descriptor, bool multishot = true, bool direct = false)
+            : Operation(OperationType::ACCEPT_MULTISHOT, *file_descriptor)
+            , file_descriptor_(file_descriptor)
+            , multishot_(multishot)
+            , direct_(direct)
+            , result_(-EAGAIN)
+        {
+        }
+
+        // The result of the final completion, or -EAGAIN while still accepting.
+        int32_t result() const {
+            return result_;
+        }
+
+        // Returns accepted connections in the order they arrived.
+        Ptr<FileDescriptor> accept() {
+            if (connections_.empty()) {
+                return {};
+            }
+
+            Ref<FileDescriptor> connection = std::move(connections_.front());
+            connections_.pop_front();
+
+            // Stay readable once the operation has terminated so the result can be observed.
+            if (connections_.empty() && !is_complete()) {
+                readable_event().reset();
+            }
+
+            return connection;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            // Direct descriptors aren't in the process file table, so they can't take SOCK_CLOEXEC.
+            if (direct_ && multishot_) {
+                io_uring_prep_multishot_accept_direct(&io_sqe, file_descriptor_->borrow(), nullptr, nullptr, 0);
+            }
+            else if (direct_) {
+                io_uring_prep_accept_direct(&io_sqe, file_descriptor_->borrow(), nullptr, nullptr, 0, IORING_FILE_INDEX_ALLOC);
+            }
+            else if (multishot_) {
+                io_uring_prep_multishot_accept(&io_sqe, file_descriptor_->borrow(), nullptr, nullptr, SOCK_CLOEXEC);
+            }
+            else {
+                io_uring_prep_accept(&io_sqe, file_descriptor_->borrow(), nullptr, nullptr, SOCK_CLOEXEC);
+            }
+            file_descriptor_->prepare(io_sqe);
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
+            if (result >= 0) {
+                if (direct_) {
+                    // The result is the slot. It is cleared like any other fixed file when the
+                    // connection is finalized.
+                    Ref<FileDescriptor> connection = make_file_descriptor(-1);
+                    connection->attach_fixed_file(static_cast<FixedFileIndex>(result));
+                    connections_.push_back(std::move(connection));
+                }
+                else {
+                    connections_.push_back(make_file_descriptor(result));
+                }
+            }
+
+            if (!more) {
+                result_ = std::min(result, 0);
+            }
+
+            if (!connections_.empty() || !more) {
+                readable_event().set();
+            }
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        Ref<FileDescriptor>             file_descriptor_;
+        bool                            multishot_;
+        bool                            direct_;
+        int32_t                         result_;
+        std::deque<Ref<FileDescriptor>> connections_;
+    };
+
+}
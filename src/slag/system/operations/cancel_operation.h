@@ -0,0 +1,70 @@
+#pragma once
+
+#include <liburing.h>
+#include "slag/core.h"
+#include "slag/system/operation.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    // Cancels every request in flight on a file descriptor with a single submission. This is
+    // cheaper than canceling each operation when tearing down a busy connection. Operations
+    // that were submitted before this complete with -ECANCELED as usual, and canceling them
+    // afterwards (or abandoning them) doesn't submit anything. Without kernel support it
+    // completes with -EOPNOTSUPP and the operations have to be canceled one by one.
+    class CancelOperation final : public Operation {
+    public:
+        explicit CancelOperation(const Ref<FileDescriptor>& file_descriptor)
+            : Operation(OperationType::CANCEL)
+            , file_descriptor_(file_descriptor)
+            , generation_(0)
+            , result_(-EAGAIN)
+        {
+        }
+
+        // The number of requests that were canceled, or an error.
+        int32_t result() const {
+            return result_;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            unsigned flags = IORING_ASYNC_CANCEL_ALL;
+            if (std::optional<FixedFileIndex> index = file_descriptor_->fixed_file_index()) {
+                io_uring_prep_cancel_fd(&io_sqe, static_cast<int>(*index), flags | IORING_ASYNC_CANCEL_FD_FIXED);
+            }
+            else {
+                io_uring_prep_cancel_fd(&io_sqe, file_descriptor_->borrow(), flags);
+            }
+
+            // Everything that was prepared before this is covered if it succeeds.
+            generation_ = file_descriptor_->advance_cancel_generation();
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
+            assert(!more);
+
+            // Nothing to cancel isn't an error here.
+            result_ = (result == -ENOENT) ? 0 : result;
+            if (result_ >= 0) {
+                file_descriptor_->complete_cancel_generation(generation_);
+            }
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        Ref<FileDescriptor> file_descriptor_;
+        uint32_t            generation_;
+        int32_t             result_;
+    };
+
+}
@@ -25,11 +25,13 @@ namespace slag {
         }
 
     private:
+        friend Operation;
+
         void prepare_operation(struct io_uring_sqe& io_sqe) override {
             io_uring_prep_close(&io_sqe, file_descriptor_);
         }
 
-        void handle_operation_result(int32_t result, bool more) override {
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
             assert(!more);
 
             result_ = result;
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <liburing.h>
+#include <cstring>
+#include "slag/core.h"
+#include "slag/system/operation.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    class ConnectOperation final : public Operation {
+    public:
+        ConnectOperation(const Ref<FileDescriptor>& file_descriptor, const struct sockaddr& address, socklen_t address_length)
+            : Operation(OperationType::CONNECT, *file_descriptor)
+            , file_descriptor_(file_descriptor)
+            , address_length_(address_length)
+            , result_(-EAGAIN)
+        {
+            // The kernel reads the address when the submission is consumed.
+            assert(address_length_ <= sizeof(address_));
+            memcpy(&address_, &address, address_length_);
+        }
+
+        int32_t result() const {
+            return result_;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            io_uring_prep_connect(
+                &io_sqe,
+                file_descriptor_->borrow(),
+                reinterpret_cast<const struct sockaddr*>(&address_),
+                address_length_
+            );
+            file_descriptor_->prepare(io_sqe);
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
+            assert(!more);
+
+            result_ = result;
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        Ref<FileDescriptor>     file_descriptor_;
+        struct sockaddr_storage address_;
+        socklen_t               address_length_;
+        int32_t                 result_;
+    };
+
+}
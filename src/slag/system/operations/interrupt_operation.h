@@ -10,6 +10,8 @@
 
 namespace slag {
 
+    // Posts an interrupt to another reactor. It can be restarted once it completes, so that
+    // senders don't need to allocate one each time.
     class InterruptOperation final : public Operation {
     public:
         InterruptOperation(std::shared_ptr<Reactor> reactor, const Interrupt interrupt)
@@ -24,7 +26,15 @@ namespace slag {
             return result_;
         }
 
+        // Submits the interrupt again once it has completed (see `Operation::reset`).
+        void restart() {
+            reset();
+            result_ = -EAGAIN;
+        }
+
     private:
+        friend Operation;
+
         void prepare_operation(struct io_uring_sqe& io_sqe) override {
             static constexpr int flags = 0;
 
@@ -40,7 +50,7 @@ namespace slag {
             );
         }
 
-        void handle_operation_result(int32_t result, bool more) override {
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
             assert(!more);
 
             result_ = result;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <liburing.h>
+#include <vector>
+#include "slag/core.h"
+#include "slag/system/operation.h"
+
+namespace slag {
+
+    // Submits a sequence of operations as one IOSQE_IO_LINK chain, so that each step is
+    // started by the kernel when the previous one succeeds. A step that fails breaks the
+    // chain, and the remaining steps complete with -ECANCELED.
+    //
+    // Each step reports its own result as usual. The chain itself completes once, after
+    // the last step, with 0 if every step ran or -ECANCELED if the chain was broken.
+    // Steps must not be scheduled separately, and must not be multishot operations. A chain
+    // that doesn't fit in the submission queue completes with -EINVAL without running.
+    class LinkedOperation final : public Operation {
+    public:
+        explicit LinkedOperation(std::vector<Ref<Operation>> steps)
+            : Operation(OperationType::LINKED)
+            , steps_(std::move(steps))
+            , result_(-EAGAIN)
+        {
+            assert(!steps_.empty());
+        }
+
+        int32_t result() const {
+            return result_;
+        }
+
+        size_t step_count() const {
+            return steps_.size();
+        }
+
+        Operation& step(const size_t index) {
+            return *steps_.at(index);
+        }
+
+    private:
+        friend Operation;
+
+        // The trailing nop completes after every step in the chain.
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            io_uring_prep_nop(&io_sqe);
+        }
+
+        void prepare_cancel(struct io_uring_sqe& io_sqe) override {
+            // Canceling the step that is running breaks the chain, and the kernel cancels the
+            // steps that follow it (the ones that haven't started can't be found by key).
+            for (Ref<Operation>& step: steps_) {
+                if (step->state() != OperationState::COMPLETE) {
+                    io_uring_prep_cancel64(&io_sqe, encode_operation_key(step->key()), 0);
+                    return;
+                }
+            }
+
+            Operation::prepare_cancel(io_sqe);
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
+            assert(!more);
+
+            // The chain was never submitted (canceled or rejected while pending).
+            for (Ref<Operation>& step: steps_) {
+                if (step->state() == OperationState::OPERATION_PENDING) {
+                    step->cancel();
+                }
+            }
+
+            result_ = result;
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        std::vector<Ref<Operation>> steps_;
+        int32_t                     result_;
+    };
+
+}
@@ -12,7 +12,7 @@ namespace slag {
     class PollMultishotOperation final : public Operation {
     public:
         PollMultishotOperation(const Ref<FileDescriptor>& file_descriptor)
-            : Operation(OperationType::POLL_MULTISHOT)
+            : Operation(OperationType::POLL_MULTISHOT, *file_descriptor)
             , file_descriptor_(file_descriptor)
             , result_(-EAGAIN)
         {
@@ -23,11 +23,14 @@ namespace slag {
         }
 
     private:
+        friend Operation;
+
         void prepare_operation(struct io_uring_sqe& io_sqe) override {
             io_uring_prep_poll_multishot(&io_sqe, file_descriptor_->borrow(), POLLIN);
+            file_descriptor_->prepare(io_sqe);
         }
 
-        void handle_operation_result(int32_t result, bool more) override {
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
             (void)more;
 
             result_ = result;
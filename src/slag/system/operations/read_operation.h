@@ -0,0 +1,72 @@
+#pragma once
+
+#include <liburing.h>
+#include "slag/core.h"
+#include "slag/memory/buffer.h"
+#include "slag/system/operation.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    // Reads into the slice at an offset (or the current position). Slices of registered
+    // buffers use the fixed variant.
+    class ReadOperation final : public Operation {
+    public:
+        ReadOperation(const Ref<FileDescriptor>& file_descriptor, BufferSlice slice, uint64_t offset = CURRENT_FILE_POSITION)
+            : Operation(OperationType::READ, *file_descriptor)
+            , file_descriptor_(file_descriptor)
+            , slice_(std::move(slice))
+            , offset_(offset)
+            , result_(-EAGAIN)
+        {
+        }
+
+        // The number of bytes read (0 on EOF), or an error.
+        int32_t result() const {
+            return result_;
+        }
+
+        BufferSlice& slice() {
+            return slice_;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            std::span<std::byte> selection = slice_.selection();
+            const int file_descriptor = file_descriptor_->borrow();
+            const unsigned size = static_cast<unsigned>(selection.size());
+
+            if (std::optional<uint16_t> buffer_index = registered_buffer_index(slice_)) {
+                io_uring_prep_read_fixed(&io_sqe, file_descriptor, selection.data(), size, offset_, *buffer_index);
+            }
+            else {
+                io_uring_prep_read(&io_sqe, file_descriptor, selection.data(), size, offset_);
+            }
+
+            file_descriptor_->prepare(io_sqe);
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
+            assert(!more);
+
+            result_ = result;
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        Ref<FileDescriptor> file_descriptor_;
+        BufferSlice         slice_;
+        uint64_t            offset_;
+        int32_t             result_;
+    };
+
+}
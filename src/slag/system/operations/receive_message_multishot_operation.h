@@ -0,0 +1,147 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <liburing.h>
+#include <algorithm>
+#include <optional>
+#include <deque>
+#include <cstring>
+#include "slag/core.h"
+#include "slag/memory/buffer.h"
+#include "slag/system/operation.h"
+#include "slag/system/datagram.h"
+#include "slag/system/buffer_ring.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    // Receives datagrams, along with their source addresses, into buffers selected from a provided
+    // buffer ring until the kernel terminates the operation.
+    // Without multishot support it receives once, and then stops as if the kernel had.
+    class ReceiveMessageMultishotOperation final : public Operation {
+    public:
+        ReceiveMessageMultishotOperation(const Ref<FileDescriptor>& file_descriptor, BufferRing& buffer_ring, bool multishot = true)
+            : Operation(OperationType::RECVMSG_MULTISHOT, *file_descriptor)
+            , file_descriptor_(file_descriptor)
+            , buffer_ring_(buffer_ring)
+            , multishot_(multishot)
+            , result_(-EAGAIN)
+        {
+            memset(&message_header_, 0, sizeof(message_header_));
+            memset(&address_, 0, sizeof(address_));
+        }
+
+        // The result of the final completion, or -EAGAIN while still receiving or if the kernel
+        // stopped with data in hand (start another operation to keep receiving).
+        int32_t result() const {
+            return result_;
+        }
+
+        // Returns received datagrams in the order they arrived.
+        std::optional<Datagram> receive() {
+            if (datagrams_.empty()) {
+                return std::nullopt;
+            }
+
+            Datagram datagram = std::move(datagrams_.front());
+            datagrams_.pop_front();
+
+            // Stay readable once the operation has terminated so the result can be observed.
+            if (datagrams_.empty() && !is_complete()) {
+                readable_event().reset();
+            }
+
+            return datagram;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            if (multishot_) {
+                // This only describes the layout of each selected buffer: a header, the source
+                // address and then the payload.
+                message_header_.msg_name = nullptr;
+                message_header_.msg_namelen = sizeof(struct sockaddr_storage);
+                io_uring_prep_recvmsg_multishot(&io_sqe, file_descriptor_->borrow(), &message_header_, 0);
+            }
+            else {
+                // The payload fills the selected buffer, and the source address is written here.
+                message_header_.msg_name = &address_;
+                message_header_.msg_namelen = sizeof(address_);
+                io_uring_prep_recvmsg(&io_sqe, file_descriptor_->borrow(), &message_header_, 0);
+            }
+            io_sqe.flags |= IOSQE_BUFFER_SELECT;
+            io_sqe.buf_group = buffer_ring_.group_id();
+            file_descriptor_->prepare(io_sqe);
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t flags) override {
+            if (flags & IORING_CQE_F_BUFFER) {
+                const uint16_t buffer_id = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+
+                // Take the buffer even if it is unusable so that it makes it back to the ring.
+                Ref<Buffer> buffer = buffer_ring_.select(buffer_id);
+                if (result > 0) {
+                    if (multishot_) {
+                        parse(buffer, result);
+                    }
+                    else {
+                        const socklen_t address_length = std::min<socklen_t>(message_header_.msg_namelen, sizeof(address_));
+                        datagrams_.emplace_back(
+                            reinterpret_cast<const struct sockaddr&>(address_),
+                            address_length,
+                            BufferSlice(buffer, buffer->storage().first(static_cast<size_t>(result)))
+                        );
+                    }
+                }
+            }
+
+            if (!more) {
+                // A final completion with data isn't EOF, the kernel just stopped multishot.
+                result_ = (result > 0) ? -EAGAIN : result;
+            }
+
+            if (!datagrams_.empty() || !more) {
+                readable_event().set();
+            }
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+        void parse(const Ref<Buffer>& buffer, int32_t length) {
+            std::span<std::byte> storage = buffer->storage();
+
+            struct io_uring_recvmsg_out* message = io_uring_recvmsg_validate(storage.data(), length, &message_header_);
+            if (!message) {
+                return; // Truncated.
+            }
+
+            std::byte* payload = static_cast<std::byte*>(io_uring_recvmsg_payload(message, &message_header_));
+            const size_t payload_length = io_uring_recvmsg_payload_length(message, length, &message_header_);
+
+            const socklen_t address_length = std::min<socklen_t>(message->namelen, message_header_.msg_namelen);
+            datagrams_.emplace_back(
+                *static_cast<const struct sockaddr*>(io_uring_recvmsg_name(message)),
+                address_length,
+                BufferSlice(buffer, storage.subspan(static_cast<size_t>(payload - storage.data()), payload_length))
+            );
+        }
+
+    private:
+        Ref<FileDescriptor>     file_descriptor_;
+        BufferRing&             buffer_ring_;
+        bool                    multishot_;
+        struct msghdr           message_header_;
+        struct sockaddr_storage address_; // The source of a single-shot receive.
+        int32_t                 result_;
+        std::deque<Datagram>    datagrams_;
+    };
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <liburing.h>
+#include <algorithm>
+#include <optional>
+#include <deque>
+#include "slag/core.h"
+#include "slag/memory/buffer.h"
+#include "slag/system/operation.h"
+#include "slag/system/buffer_ring.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    // Receives into buffers selected from a provided buffer ring until the kernel terminates
+    // the operation (EOF, error, or the ring running dry with -ENOBUFS).
+    // Without multishot support it receives once, and then stops as if the kernel had.
+    class ReceiveMultishotOperation final : public Operation {
+    public:
+        ReceiveMultishotOperation(const Ref<FileDescriptor>& file_descriptor, BufferRing& buffer_ring, bool multishot = true)
+            : Operation(OperationType::RECV_MULTISHOT, *file_descriptor)
+            , file_descriptor_(file_descriptor)
+            , buffer_ring_(buffer_ring)
+            , multishot_(multishot)
+            , result_(-EAGAIN)
+        {
+        }
+
+        // The result of the final completion (0 on EOF), or -EAGAIN while still receiving or if
+        // the kernel stopped with data in hand (start another operation to keep receiving).
+        int32_t result() const {
+            return result_;
+        }
+
+        // Returns received data in the order it arrived.
+        std::optional<BufferSlice> receive() {
+            if (slices_.empty()) {
+                return std::nullopt;
+            }
+
+            BufferSlice slice = std::move(slices_.front());
+            slices_.pop_front();
+
+            // Stay readable once the operation has terminated so the result can be observed.
+            if (slices_.empty() && !is_complete()) {
+                readable_event().reset();
+            }
+
+            return slice;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            if (multishot_) {
+                io_uring_prep_recv_multishot(&io_sqe, file_descriptor_->borrow(), nullptr, 0, 0);
+            }
+            else {
+                io_uring_prep_recv(&io_sqe, file_descriptor_->borrow(), nullptr, 0, 0);
+            }
+            io_sqe.flags |= IOSQE_BUFFER_SELECT;
+            io_sqe.buf_group = buffer_ring_.group_id();
+            file_descriptor_->prepare(io_sqe);
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t flags) override {
+            if (flags & IORING_CQE_F_BUFFER) {
+                const uint16_t buffer_id = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+
+                // Take the buffer even if it is empty so that it makes it back to the ring.
+                Ref<Buffer> buffer = buffer_ring_.select(buffer_id);
+                if (result > 0) {
+                    slices_.emplace_back(buffer, buffer->storage().first(static_cast<size_t>(result)));
+                }
+            }
+
+            if (!more) {
+                // A final completion with data isn't EOF, the kernel just stopped multishot.
+                result_ = (result > 0) ? -EAGAIN : result;
+            }
+
+            if (!slices_.empty() || !more) {
+                readable_event().set();
+            }
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        Ref<FileDescriptor>     file_descriptor_;
+        BufferRing&             buffer_ring_;
+        bool                    multishot_;
+        int32_t                 result_;
+        std::deque<BufferSlice> slices_;
+    };
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <liburing.h>
+#include <memory>
+#include "slag/core.h"
+#include "slag/system/reactor.h"
+#include "slag/system/operation.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    // Installs a fixed file into the file table of another reactor, which picks the slot. The
+    // file stays in this reactor's table as well until it is unregistered here.
+    class SendFileDescriptorOperation final : public Operation {
+    public:
+        SendFileDescriptorOperation(std::shared_ptr<Reactor> reactor, const Ref<FileDescriptor>& file_descriptor)
+            : Operation(OperationType::SEND_FD)
+            , reactor_(std::move(reactor))
+            , file_descriptor_(file_descriptor)
+            , result_(-EAGAIN)
+        {
+            assert(file_descriptor_->is_fixed());
+        }
+
+        // The slot in the other reactor's fixed file table, or an error.
+        int32_t result() const {
+            return result_;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            // The other reactor doesn't get a completion (it wouldn't know what to do with it),
+            // so the user data is unused.
+            static constexpr uint64_t data = 0;
+
+            io_uring_prep_msg_ring_fd_alloc(
+                &io_sqe,
+                reactor_->borrow_file_descriptor(),
+                static_cast<int>(*file_descriptor_->fixed_file_index()),
+                data,
+                IORING_MSG_RING_CQE_SKIP
+            );
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
+            assert(!more);
+
+            result_ = result;
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        std::shared_ptr<Reactor> reactor_;
+        Ref<FileDescriptor>      file_descriptor_;
+        int32_t                  result_;
+    };
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <liburing.h>
+#include <vector>
+#include <cstring>
+#include "slag/core.h"
+#include "slag/memory/buffer.h"
+#include "slag/system/operation.h"
+#include "slag/system/datagram.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    // Sends a batch of datagrams with one submission entry each, all prepared in the same
+    // submission pass. Completions can't be told apart, so the batch reports how many
+    // datagrams were sent and the first error.
+    class SendMessageBatchOperation final : public Operation {
+    public:
+        SendMessageBatchOperation(const Ref<FileDescriptor>& file_descriptor, std::vector<Datagram> datagrams, int flags = MSG_NOSIGNAL)
+            : Operation(OperationType::SENDMSG_BATCH, *file_descriptor)
+            , file_descriptor_(file_descriptor)
+            , datagrams_(std::move(datagrams))
+            , flags_(flags)
+            , sent_count_(0)
+            , result_(0)
+        {
+            assert(!datagrams_.empty());
+
+            // The kernel reads these when the submissions are consumed.
+            iovecs_.resize(datagrams_.size());
+            message_headers_.resize(datagrams_.size());
+            for (size_t index = 0; index < datagrams_.size(); ++index) {
+                Datagram& datagram = datagrams_[index];
+                std::span<std::byte> selection = datagram.payload.selection();
+
+                iovecs_[index] = {
+                    .iov_base = selection.data(),
+                    .iov_len  = selection.size(),
+                };
+
+                struct msghdr& message_header = message_headers_[index];
+                memset(&message_header, 0, sizeof(message_header));
+                message_header.msg_name = datagram.address_length ? &datagram.address : nullptr;
+                message_header.msg_namelen = datagram.address_length;
+                message_header.msg_iov = &iovecs_[index];
+                message_header.msg_iovlen = 1;
+            }
+        }
+
+        size_t datagram_count() const {
+            return datagrams_.size();
+        }
+
+        size_t sent_count() const {
+            return sent_count_;
+        }
+
+        // Zero if every datagram was sent, otherwise the first error.
+        int32_t result() const {
+            return result_;
+        }
+
+    private:
+        friend Operation;
+
+        size_t operation_entry_count() const override {
+            return datagrams_.size();
+        }
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            struct io_uring_sqe* io_sqes[] = {&io_sqe};
+            prepare_operation_batch(io_sqes);
+        }
+
+        void prepare_operation_batch(std::span<struct io_uring_sqe* const> io_sqes) override {
+            assert(io_sqes.size() == message_headers_.size());
+
+            for (size_t index = 0; index < io_sqes.size(); ++index) {
+                struct io_uring_sqe& io_sqe = *io_sqes[index];
+
+                io_uring_prep_sendmsg(&io_sqe, file_descriptor_->borrow(), &message_headers_[index], flags_);
+                file_descriptor_->prepare(io_sqe);
+            }
+        }
+
+        void prepare_cancel(struct io_uring_sqe& io_sqe) override {
+            Operation::prepare_cancel(io_sqe);
+            io_sqe.cancel_flags |= IORING_ASYNC_CANCEL_ALL;
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
+            assert(!more);
+
+            if (result >= 0) {
+                sent_count_ += 1;
+            }
+            else if (result_ == 0) {
+                result_ = result;
+            }
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if ((result >= 0) && (result_ == 0)) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        Ref<FileDescriptor>        file_descriptor_;
+        std::vector<Datagram>      datagrams_;
+        std::vector<struct iovec>  iovecs_;
+        std::vector<struct msghdr> message_headers_;
+        int                        flags_;
+        size_t                     sent_count_;
+        int32_t                    result_;
+    };
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <liburing.h>
+#include <optional>
+#include "slag/core.h"
+#include "slag/memory/buffer.h"
+#include "slag/system/operation.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    // Sends directly from the buffer instead of copying it into the socket. The kernel posts the
+    // result first (readable), and a notification once it no longer references the buffer
+    // (complete). The buffer is kept alive until then. Without zero copy support it is a plain
+    // send, which posts the result and completes at once.
+    class SendZeroCopyOperation final : public Operation {
+    public:
+        SendZeroCopyOperation(const Ref<FileDescriptor>& file_descriptor, BufferSlice slice, int flags = MSG_NOSIGNAL, bool zero_copy = true)
+            : Operation(OperationType::SEND_ZC, *file_descriptor)
+            , file_descriptor_(file_descriptor)
+            , slice_(std::move(slice))
+            , flags_(flags)
+            , zero_copy_(zero_copy)
+            , result_(-EAGAIN)
+        {
+        }
+
+        // The number of bytes sent, or an error.
+        int32_t result() const {
+            return result_;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            std::span<std::byte> selection = slice_->selection();
+
+            if (zero_copy_) {
+                io_uring_prep_send_zc(&io_sqe, file_descriptor_->borrow(), selection.data(), selection.size(), flags_, 0);
+            }
+            else {
+                io_uring_prep_send(&io_sqe, file_descriptor_->borrow(), selection.data(), selection.size(), flags_);
+            }
+            file_descriptor_->prepare(io_sqe);
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t flags) override {
+            if (flags & IORING_CQE_F_NOTIF) {
+                assert(!more);
+            }
+            else {
+                result_ = result;
+                readable_event().set();
+            }
+
+            if (!more) {
+                slice_.reset(); // The kernel is done with the buffer.
+            }
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        Ref<FileDescriptor>        file_descriptor_;
+        std::optional<BufferSlice> slice_;
+        int                        flags_;
+        bool                       zero_copy_;
+        int32_t                    result_;
+    };
+
+}
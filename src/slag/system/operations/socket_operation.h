@@ -0,0 +1,64 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <liburing.h>
+#include "slag/core.h"
+#include "slag/system/operation.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    class SocketOperation final : public Operation {
+    public:
+        SocketOperation(int domain, int type, int protocol = 0)
+            : Operation(OperationType::SOCKET)
+            , domain_(domain)
+            , type_(type)
+            , protocol_(protocol)
+            , result_(-EAGAIN)
+        {
+        }
+
+        int32_t result() const {
+            return result_;
+        }
+
+        // The new socket, once the operation has completed successfully.
+        Ptr<FileDescriptor> file_descriptor() const {
+            return file_descriptor_;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            io_uring_prep_socket(&io_sqe, domain_, type_ | SOCK_CLOEXEC, protocol_, 0);
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
+            assert(!more);
+
+            result_ = result;
+            if (result >= 0) {
+                // Owned immediately so that it is closed if nobody claims it.
+                file_descriptor_ = make_file_descriptor(result);
+            }
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        int                 domain_;
+        int                 type_;
+        int                 protocol_;
+        int32_t             result_;
+        Ptr<FileDescriptor> file_descriptor_;
+    };
+
+}
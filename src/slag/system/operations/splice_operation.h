@@ -0,0 +1,93 @@
+#pragma once
+
+#include <fcntl.h>
+#include <liburing.h>
+#include "slag/core.h"
+#include "slag/system/operation.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    // Moves up to `length` bytes between two file descriptors inside the kernel. One
+    // of them has to be a pipe, and pipes have to use the current position.
+    class SpliceOperation final : public Operation {
+    public:
+        SpliceOperation(
+            const Ref<FileDescriptor>& source,
+            uint64_t                   source_offset,
+            const Ref<FileDescriptor>& sink,
+            uint64_t                   sink_offset,
+            uint32_t                   length,
+            unsigned                   flags = SPLICE_F_MOVE)
+            : Operation(OperationType::SPLICE)
+            , source_(source)
+            , sink_(sink)
+            , source_offset_(source_offset)
+            , sink_offset_(sink_offset)
+            , length_(length)
+            , flags_(flags)
+            , result_(-EAGAIN)
+        {
+        }
+
+        SpliceOperation(const Ref<FileDescriptor>& source, const Ref<FileDescriptor>& sink, uint32_t length, unsigned flags = SPLICE_F_MOVE)
+            : SpliceOperation(source, CURRENT_FILE_POSITION, sink, CURRENT_FILE_POSITION, length, flags)
+        {
+        }
+
+        uint32_t length() const {
+            return length_;
+        }
+
+        // The number of bytes moved (0 on EOF), or an error.
+        int32_t result() const {
+            return result_;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            io_uring_prep_splice(
+                &io_sqe,
+                source_->borrow(),
+                static_cast<int64_t>(source_offset_),
+                sink_->borrow(),
+                static_cast<int64_t>(sink_offset_),
+                length_,
+                flags_
+            );
+
+            // The sink is the primary file of the submission, and the source has its own flag.
+            sink_->prepare(io_sqe);
+            if (std::optional<FixedFileIndex> index = source_->fixed_file_index()) {
+                io_sqe.splice_fd_in = static_cast<int32_t>(*index);
+                io_sqe.splice_flags |= SPLICE_F_FD_IN_FIXED;
+            }
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
+            assert(!more);
+
+            result_ = result;
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        Ref<FileDescriptor> source_;
+        Ref<FileDescriptor> sink_;
+        uint64_t            source_offset_;
+        uint64_t            sink_offset_;
+        uint32_t            length_;
+        unsigned            flags_;
+        int32_t             result_;
+    };
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <fcntl.h>
+#include <liburing.h>
+#include "slag/core.h"
+#include "slag/system/operation.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    // Duplicates up to `length` bytes from one pipe into another without consuming them.
+    class TeeOperation final : public Operation {
+    public:
+        TeeOperation(const Ref<FileDescriptor>& source, const Ref<FileDescriptor>& sink, uint32_t length, unsigned flags = 0)
+            : Operation(OperationType::TEE)
+            , source_(source)
+            , sink_(sink)
+            , length_(length)
+            , flags_(flags)
+            , result_(-EAGAIN)
+        {
+        }
+
+        uint32_t length() const {
+            return length_;
+        }
+
+        // The number of bytes duplicated (0 if the source is empty and has no writers), or an error.
+        int32_t result() const {
+            return result_;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            io_uring_prep_tee(&io_sqe, source_->borrow(), sink_->borrow(), length_, flags_);
+
+            sink_->prepare(io_sqe);
+            if (std::optional<FixedFileIndex> index = source_->fixed_file_index()) {
+                io_sqe.splice_fd_in = static_cast<int32_t>(*index);
+                io_sqe.splice_flags |= SPLICE_F_FD_IN_FIXED;
+            }
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
+            assert(!more);
+
+            result_ = result;
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        Ref<FileDescriptor> source_;
+        Ref<FileDescriptor> sink_;
+        uint32_t            length_;
+        unsigned            flags_;
+        int32_t             result_;
+    };
+
+}
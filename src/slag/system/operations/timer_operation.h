@@ -0,0 +1,63 @@
+#pragma once
+
+#include <liburing.h>
+#include <chrono>
+#include "slag/core.h"
+#include "slag/system/operation.h"
+
+namespace slag {
+
+    // Completes with -ETIME once the (monotonic) deadline has passed.
+    class TimerOperation final : public Operation {
+    public:
+        using Clock     = std::chrono::steady_clock;
+        using TimePoint = Clock::time_point;
+
+        explicit TimerOperation(const TimePoint deadline)
+            : Operation(OperationType::TIMER)
+            , deadline_(deadline)
+            , result_(-EAGAIN)
+            , timespec_(to_kernel_timespec(deadline)) // The kernel reads this when the submission is consumed.
+        {
+        }
+
+        TimePoint deadline() const {
+            return deadline_;
+        }
+
+        int32_t result() const {
+            return result_;
+        }
+
+        bool is_expired() const {
+            return result_ == -ETIME;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            io_uring_prep_timeout(&io_sqe, &timespec_, 0, IORING_TIMEOUT_ABS);
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
+            assert(!more);
+
+            result_ = result;
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        TimePoint                deadline_;
+        int32_t                  result_;
+        struct __kernel_timespec timespec_;
+    };
+
+}
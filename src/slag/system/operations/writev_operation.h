@@ -0,0 +1,74 @@
+#pragma once
+
+#include <sys/uio.h>
+#include <liburing.h>
+#include <vector>
+#include "slag/core.h"
+#include "slag/memory/buffer.h"
+#include "slag/system/operation.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    // Writes from a chain of slices in order, at an offset (or the current position).
+    class WritevOperation final : public Operation {
+    public:
+        WritevOperation(const Ref<FileDescriptor>& file_descriptor, std::vector<BufferSlice> slices, uint64_t offset = CURRENT_FILE_POSITION)
+            : Operation(OperationType::WRITEV, *file_descriptor)
+            , file_descriptor_(file_descriptor)
+            , slices_(std::move(slices))
+            , offset_(offset)
+            , result_(-EAGAIN)
+        {
+            // The kernel reads these when the submission is consumed.
+            iovecs_.reserve(slices_.size());
+            for (BufferSlice& slice: slices_) {
+                std::span<std::byte> selection = slice.selection();
+
+                iovecs_.push_back({
+                    .iov_base = selection.data(),
+                    .iov_len  = selection.size(),
+                });
+            }
+        }
+
+        // The total number of bytes written, or an error.
+        int32_t result() const {
+            return result_;
+        }
+
+        std::vector<BufferSlice>& slices() {
+            return slices_;
+        }
+
+    private:
+        friend Operation;
+
+        void prepare_operation(struct io_uring_sqe& io_sqe) override {
+            io_uring_prep_writev(&io_sqe, file_descriptor_->borrow(), iovecs_.data(), static_cast<unsigned>(iovecs_.size()), offset_);
+            file_descriptor_->prepare(io_sqe);
+        }
+
+        void handle_operation_result(int32_t result, bool more, uint32_t) override {
+            assert(!more);
+
+            result_ = result;
+        }
+
+        void handle_cancel_result(int32_t result, bool more) override {
+            assert(!more);
+
+            if (result >= 0) {
+                result_ = -ECANCELED;
+            }
+        }
+
+    private:
+        Ref<FileDescriptor>       file_descriptor_;
+        std::vector<BufferSlice>  slices_;
+        std::vector<struct iovec> iovecs_;
+        uint64_t                  offset_;
+        int32_t                   result_;
+    };
+
+}
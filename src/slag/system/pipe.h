@@ -0,0 +1,98 @@
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include "slag/core.h"
+#include "slag/resource.h"
+#include "slag/system/file_descriptor.h"
+
+namespace slag {
+
+    // A kernel pipe used to move data between file descriptors with splice and tee,
+    // without copying it through user space.
+    template<>
+    class Resource<ResourceType::PIPE> : public Object {
+    public:
+        // Uses the kernel's default capacity when it is zero.
+        explicit Resource(size_t capacity = 0)
+            : Resource(create(), capacity)
+        {
+        }
+
+        const Ref<FileDescriptor>& reader() const {
+            return reader_;
+        }
+
+        const Ref<FileDescriptor>& writer() const {
+            return writer_;
+        }
+
+        size_t capacity() const {
+            return capacity_;
+        }
+
+        // The kernel rounds the capacity up to a power of two pages. This fails if the capacity
+        // exceeds the system limit, or is smaller than the data in the pipe.
+        [[nodiscard]]
+        bool resize(size_t capacity) {
+            const int result = fcntl(writer_->borrow(), F_SETPIPE_SZ, static_cast<int>(capacity));
+            if (result < 0) {
+                return false;
+            }
+
+            capacity_ = static_cast<size_t>(result);
+            return true;
+        }
+
+    private:
+        Resource(const std::array<int, 2> file_descriptors, size_t capacity)
+            : Object(static_cast<ObjectGroup>(ResourceType::PIPE))
+            , reader_(make_file_descriptor(file_descriptors[0]))
+            , writer_(make_file_descriptor(file_descriptors[1]))
+            , capacity_(0)
+        {
+            if (capacity) {
+                if (!resize(capacity)) {
+                    throw std::runtime_error(strerror(errno));
+                }
+            }
+            else {
+                capacity_ = query_capacity();
+            }
+        }
+
+        static std::array<int, 2> create() {
+            std::array<int, 2> file_descriptors;
+            if (pipe2(file_descriptors.data(), O_CLOEXEC) < 0) {
+                throw std::runtime_error(strerror(errno));
+            }
+
+            return file_descriptors;
+        }
+
+        size_t query_capacity() {
+            const int result = fcntl(writer_->borrow(), F_GETPIPE_SZ);
+            if (result < 0) {
+                throw std::runtime_error(strerror(errno));
+            }
+
+            return static_cast<size_t>(result);
+        }
+
+    private:
+        Ref<FileDescriptor> reader_;
+        Ref<FileDescriptor> writer_;
+        size_t              capacity_;
+    };
+
+    template<typename... Args>
+    inline Ref<Pipe> make_pipe(Args&&... args) {
+        return bind(
+            *new Pipe(std::forward<Args>(args)...)
+        );
+    }
+
+}
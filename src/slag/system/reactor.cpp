@@ -1,28 +1,250 @@
 #include "reactor.h"
+#include "operations.h"
+#include <algorithm>
+#include <bit>
 #include <stdexcept>
 #include <numeric>
+#include <limits>
+#include <iterator>
 #include <cstring>
 #include <cassert>
 
 namespace slag {
 
-    Reactor::Reactor() {
+    Reactor::Reactor(const ReactorConfig& config, const int shared_workers_file_descriptor)
+        : config_(config)
+        , setup_flags_(0)
+        , features_(0)
+        , enabled_(false)
+        , busy_polling_(false)
+        , in_flight_limit_(0)
+        , in_flight_count_(0)
+        , overflowing_(false)
+        , starved_pass_counts_{}
+    {
         memset(&ring_, 0, sizeof(ring_));
 
-        int result;
-        do {
-            result = io_uring_queue_init(4096, &ring_, 0);
-        } while ((result < 0) && (errno == EINTR));
+        uint32_t flags = IORING_SETUP_CLAMP | IORING_SETUP_CQSIZE;
+        if (config_.single_issuer) {
+            // The ring is created here on the spawning thread, so it starts disabled and the
+            // event loop thread claims it (as the single issuer) when it calls `enable`.
+            flags |= IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_R_DISABLED;
+
+            if (config_.defer_taskrun && !config_.submission_polling) {
+                flags |= IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+            }
+        }
+        if (config_.cooperative_taskrun && !config_.submission_polling) {
+            flags |= IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+        }
+        if (config_.submission_polling) {
+            flags |= IORING_SETUP_SQPOLL;
+
+            if (config_.submission_polling_cpu) {
+                flags |= IORING_SETUP_SQ_AFF;
+            }
+        }
+        if (shared_workers_file_descriptor >= 0) {
+            flags |= IORING_SETUP_ATTACH_WQ;
+        }
+
+        // Optional flags, newest first, that are shed until the kernel accepts the rest.
+        static constexpr uint32_t optional_flags[] = {
+            IORING_SETUP_ATTACH_WQ,
+            IORING_SETUP_DEFER_TASKRUN,
+            IORING_SETUP_SINGLE_ISSUER,
+            IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG,
+            IORING_SETUP_R_DISABLED,
+        };
+
+        int result = -EINVAL;
+        size_t shed_count = 0;
+        while (true) {
+            struct io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            params.flags = flags;
+            params.cq_entries = config_.completion_queue_size;
+            params.sq_thread_cpu = config_.submission_polling_cpu.value_or(0);
+            params.sq_thread_idle = config_.submission_polling_idle_ms;
+            params.wq_fd = (flags & IORING_SETUP_ATTACH_WQ) ? static_cast<uint32_t>(shared_workers_file_descriptor) : 0;
+
+            do {
+                result = io_uring_queue_init_params(config_.submission_queue_size, &ring_, &params);
+            } while (result == -EINTR);
+
+            if (result >= 0) {
+                setup_flags_ = params.flags;
+                features_ = params.features;
+                break;
+            }
+
+            if ((result == -EPERM) && (flags & IORING_SETUP_SQPOLL)) {
+                // Older kernels only allow privileged processes to poll; submit normally instead.
+                flags &= ~(IORING_SETUP_SQPOLL | IORING_SETUP_SQ_AFF | IORING_SETUP_ATTACH_WQ);
+                continue;
+            }
+
+            if ((result != -EINVAL) || (shed_count == std::size(optional_flags))) {
+                break;
+            }
+
+            flags &= ~optional_flags[shed_count++];
+
+            // Taskrun notifications are only valid with one of the deferral modes.
+            if (!(flags & (IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_COOP_TASKRUN))) {
+                flags &= ~IORING_SETUP_TASKRUN_FLAG;
+            }
+        }
 
         if (result < 0) {
             throw std::runtime_error("Failed to initialize io_uring");
         }
+
+        // Multishot operations can post more completions than this accounts for, but the
+        // overflow check catches those.
+        in_flight_limit_ = config_.in_flight_limit ? config_.in_flight_limit : ring_.cq.ring_entries;
+        completion_batch_.reserve(ring_.cq.ring_entries);
+        sorted_completion_batch_.reserve(ring_.cq.ring_entries);
+        writable_event_.set();
+
+        // Fixed files are an optimization; fall back to plain descriptors without them. Received
+        // files and direct accepts go after the slots that we allocate, where the kernel allocates them.
+        bool receives_files = false;
+        if (io_uring_register_files_sparse(&ring_, config_.fixed_file_table_size + config_.received_file_table_size) >= 0) {
+            file_table_ = FileTable(config_.fixed_file_table_size);
+
+            if (config_.received_file_table_size > 0) {
+                receives_files = io_uring_register_file_alloc_range(
+                    &ring_,
+                    config_.fixed_file_table_size,
+                    config_.received_file_table_size
+                ) >= 0;
+            }
+        }
+
+        probe_capabilities();
+        capabilities_.set(Capability::FILE_TRANSFER, receives_files && capabilities_.has(Capability::FILE_TRANSFER));
+        capabilities_.set(Capability::DIRECT_ACCEPT, receives_files && capabilities_.has(Capability::MULTISHOT_ACCEPT));
     }
 
     Reactor::~Reactor() {
+        // The kernel may still be reading or writing registered and provided buffers.
+        drain();
+
+        buffer_rings_.clear();
+        fixed_buffer_pool_.reset();
+
         io_uring_queue_exit(&ring_);
     }
 
+    void Reactor::enable() {
+        if (enabled_) {
+            return;
+        }
+
+        if (setup_flags_ & IORING_SETUP_R_DISABLED) {
+            if (io_uring_enable_rings(&ring_) < 0) {
+                throw std::runtime_error("Failed to enable io_uring");
+            }
+        }
+
+        // Registered ring descriptors are per-thread, so this has to happen here as well.
+        // It saves an fdget/fdput on every `io_uring_enter`.
+        if (config_.register_ring_fd) {
+            (void)io_uring_register_ring_fd(&ring_);
+        }
+
+        // Sockets join the ring's NAPI list the first time they are polled through it, so this
+        // covers every socket operation that is submitted here.
+        if (config_.napi_busy_poll_timeout) {
+            struct io_uring_napi napi;
+            memset(&napi, 0, sizeof(napi));
+            napi.busy_poll_to = static_cast<uint32_t>(config_.napi_busy_poll_timeout->count());
+            napi.prefer_busy_poll = config_.napi_prefer_busy_poll;
+
+            busy_polling_ = io_uring_register_napi(&ring_, &napi) >= 0;
+        }
+
+        enabled_ = true;
+    }
+
+    const ReactorConfig& Reactor::config() const {
+        return config_;
+    }
+
+    uint32_t Reactor::setup_flags() const {
+        return setup_flags_;
+    }
+
+    uint32_t Reactor::features() const {
+        return features_;
+    }
+
+    bool Reactor::is_submission_polling() const {
+        return setup_flags_ & IORING_SETUP_SQPOLL;
+    }
+
+    bool Reactor::is_busy_polling() const {
+        return busy_polling_;
+    }
+
+    const CapabilitySet& Reactor::capabilities() const {
+        return capabilities_;
+    }
+
+    bool Reactor::has_capability(const Capability capability) const {
+        return capabilities_.has(capability);
+    }
+
+    void Reactor::probe_capabilities() {
+        capabilities_.set(Capability::FIXED_FILES, file_table_.capacity() > 0);
+
+        struct io_uring_probe* probe = io_uring_get_probe_ring(&ring_);
+        if (!probe) {
+            return; // Older than 5.6, so none of the rest are supported either.
+        }
+
+        auto is_supported = [&](const int opcode) {
+            return io_uring_opcode_supported(probe, opcode) != 0;
+        };
+
+        // Flags and multishot modes can't be probed, so these go by opcodes from the same release.
+        const bool is_5_19 = is_supported(IORING_OP_SOCKET);
+        const bool is_6_0  = is_supported(IORING_OP_SEND_ZC);
+
+        capabilities_.set(Capability::BUFFER_RING, is_5_19);
+        capabilities_.set(Capability::MULTISHOT_ACCEPT, is_5_19 && is_supported(IORING_OP_ACCEPT));
+        capabilities_.set(Capability::MULTISHOT_RECV, is_6_0 && is_supported(IORING_OP_RECV));
+        capabilities_.set(Capability::SEND_ZERO_COPY, is_6_0);
+        capabilities_.set(Capability::MSG_RING, is_supported(IORING_OP_MSG_RING));
+        capabilities_.set(Capability::FILE_TRANSFER, is_6_0 && is_supported(IORING_OP_MSG_RING));
+        capabilities_.set(Capability::CANCEL_FD, is_5_19 && is_supported(IORING_OP_ASYNC_CANCEL));
+        capabilities_.set(Capability::CANCEL_FD_FIXED, is_6_0 && is_supported(IORING_OP_ASYNC_CANCEL));
+        capabilities_.set(Capability::SPLICE, is_supported(IORING_OP_SPLICE) && is_supported(IORING_OP_TEE));
+
+        io_uring_free_probe(probe);
+    }
+
+    Event& Reactor::writable_event() {
+        return writable_event_;
+    }
+
+    size_t Reactor::in_flight_count() const {
+        return in_flight_count_;
+    }
+
+    size_t Reactor::in_flight_limit() const {
+        return in_flight_limit_;
+    }
+
+    size_t Reactor::submission_queue_size() const {
+        return ring_.sq.ring_entries;
+    }
+
+    auto Reactor::metrics() const -> const Metrics& {
+        return metrics_;
+    }
+
     int Reactor::borrow_file_descriptor() {
         return ring_.ring_fd;
     }
@@ -35,23 +257,107 @@ namespace slag {
         return interrupt_vector_[to_index(reason)];
     }
 
+    bool Reactor::register_file_descriptor(FileDescriptor& file_descriptor) {
+        if (file_descriptor.is_fixed()) {
+            return true;
+        }
+
+        int raw_file_descriptor = file_descriptor.borrow();
+        if (raw_file_descriptor < 0) {
+            return false;
+        }
+
+        const std::optional<FixedFileIndex> index = allocate_fixed_file();
+        if (!index) {
+            return false;
+        }
+
+        if (io_uring_register_files_update(&ring_, *index, &raw_file_descriptor, 1) < 0) {
+            deallocate_fixed_file(*index);
+            return false;
+        }
+
+        file_descriptor.attach_fixed_file(*index);
+        return true;
+    }
+
+    void Reactor::unregister_file_descriptor(FileDescriptor& file_descriptor) {
+        if (const std::optional<FixedFileIndex> index = file_descriptor.detach_fixed_file()) {
+            // Clearing the slot drops the table's reference to the file. Operations that are
+            // still in flight hold their own reference, and direct descriptors are closed here.
+            int cleared_file_descriptor = -1;
+            int result = io_uring_register_files_update(&ring_, *index, &cleared_file_descriptor, 1);
+            assert(result >= 0);
+            (void)result;
+
+            deallocate_fixed_file(*index);
+        }
+    }
+
+    std::optional<FixedFileIndex> Reactor::allocate_fixed_file() {
+        return file_table_.allocate();
+    }
+
+    void Reactor::deallocate_fixed_file(const FixedFileIndex index) {
+        // The kernel reclaims received slots by itself once they are cleared.
+        if (index < file_table_.capacity()) {
+            file_table_.deallocate(index);
+        }
+    }
+
+    BufferRing& Reactor::create_buffer_ring(const size_t buffer_count, const size_t buffer_size) {
+        const size_t group_id = buffer_rings_.size();
+        if (group_id > std::numeric_limits<BufferRing::GroupId>::max()) {
+            throw std::runtime_error("Too many buffer rings");
+        }
+
+        return *buffer_rings_.emplace_back(
+            std::make_unique<BufferRing>(ring_, static_cast<BufferRing::GroupId>(group_id), buffer_count, buffer_size)
+        );
+    }
+
+    FixedBufferPool& Reactor::create_fixed_buffer_pool(const size_t buffer_count, const size_t buffer_size) {
+        if (fixed_buffer_pool_) {
+            throw std::runtime_error("Fixed buffer pool already exists");
+        }
+
+        fixed_buffer_pool_ = std::make_unique<FixedBufferPool>(ring_, buffer_count, buffer_size);
+        return *fixed_buffer_pool_;
+    }
+
+    FixedBufferPool* Reactor::fixed_buffer_pool() {
+        return fixed_buffer_pool_.get();
+    }
+
     void Reactor::schedule_operation(Operation& operation) {
-        pending_submissions_.insert<PollableType::WRITABLE>(operation);
+        pending_submissions_[to_index(operation.priority())].insert<PollableType::WRITABLE>(operation);
     }
 
     void Reactor::destroy_operation(Operation& operation) {
         assert(!operation.is_managed());
         assert(operation.is_quiescent());
 
-        delete &operation;
+        SlabPool& pool = *operation_pools_[to_index(operation.type())];
+        const uint8_t key_generation = operation.key_generation();
+        std::destroy_at(&operation);
+        pool.deallocate(&operation, key_generation);
+    }
+
+    const SlabPool::Metrics* Reactor::operation_pool_metrics(const OperationType operation_type) const {
+        if (const std::unique_ptr<SlabPool>& pool = operation_pools_[to_index(operation_type)]) {
+            return &pool->metrics();
+        }
+
+        return nullptr;
     }
 
     bool Reactor::poll(const bool non_blocking) {
-        const size_t submission_count = prepare_submissions();
+        const SubmissionPass pass = prepare_submissions();
 
-        if (non_blocking) {
-            if (submission_count > 0) {
-                io_uring_submit(&ring_);
+        // Rejected operations have already completed, so there is no need to wait for another.
+        if (non_blocking || (pass.rejected_count > 0)) {
+            if (pass.submission_count > 0) {
+                submit();
             }
         }
         else {
@@ -59,92 +365,477 @@ namespace slag {
         }
 
         const size_t completion_count = process_completions();
-        return completion_count > 0;
+        update_capacity();
+        return (completion_count + pass.rejected_count) > 0;
     }
 
-    size_t Reactor::prepare_submissions() {
-        const size_t ready_count = pending_submissions_.ready_count();
+    void Reactor::submit() {
+        // When polling, this only publishes the new tail; liburing enters the kernel only
+        // if the polling thread has gone idle and set IORING_SQ_NEED_WAKEUP.
+        int result = io_uring_submit(&ring_);
+        if (UNLIKELY(result < 0)) {
+            if ((result != -EINTR) && (result != -EAGAIN) && (result != -EBUSY)) {
+                abort();
+            }
+        }
+    }
 
-        for (size_t count = 0; count < ready_count; ++count) {
-            if (struct io_uring_sqe* io_sqe = io_uring_get_sqe(&ring_)) {
-                prepare_submission(*io_sqe);
+    void Reactor::drain() {
+        // Canceling everything at once needs 5.19. Before that, the ring's exit cancels what is left.
+        if ((in_flight_count_ == 0) || !capabilities_.has(Capability::CANCEL_FD)) {
+            return;
+        }
+
+        struct io_uring_sqe* io_sqe = io_uring_get_sqe(&ring_);
+        if (!io_sqe) {
+            submit();
+            io_sqe = io_uring_get_sqe(&ring_);
+            if (!io_sqe) {
+                return;
+            }
+        }
+
+        // Its completion is ignored like a link timeout's.
+        io_uring_prep_cancel64(io_sqe, 0, IORING_ASYNC_CANCEL_ANY);
+        io_uring_sqe_set_data64(io_sqe, encode_operation_key(LINK_TIMEOUT_OPERATION_KEY));
+        in_flight_count_ += 1;
+
+        // The completions are counted, but not handed to their operations.
+        while (in_flight_count_ > 0) {
+            int result = io_uring_submit_and_wait(&ring_, 1);
+            if ((result < 0) && (result != -EINTR) && (result != -EAGAIN) && (result != -EBUSY)) {
+                return;
+            }
+
+            unsigned head;
+            unsigned completion_count = 0;
+            struct io_uring_cqe* io_cqe;
+            io_uring_for_each_cqe(&ring_, head, io_cqe) {
+                const bool is_final = !(io_cqe->flags & IORING_CQE_F_MORE);
+                if (is_final && (decode_operation_key(io_cqe->user_data) != INTERRUPT_OPERATION_KEY)) {
+                    assert(in_flight_count_ > 0);
+                    in_flight_count_ -= 1;
+                }
+                ++completion_count;
+            }
+            io_uring_cq_advance(&ring_, completion_count);
+        }
+    }
+
+    auto Reactor::prepare_submissions() -> SubmissionPass {
+        SubmissionPass pass;
+
+        // Cancels release resources, so they go first and are never held back.
+        prepare_cancels(pass);
+
+        // Higher priorities go first, except for classes that have been passed over too many
+        // times in a row.
+        std::array<OperationPriority, OPERATION_PRIORITY_COUNT> order;
+        for (size_t index = 0; index < order.size(); ++index) {
+            order[index] = static_cast<OperationPriority>(index);
+        }
+        std::stable_partition(order.begin(), order.end(), [&](const OperationPriority priority) {
+            return starved_pass_counts_[to_index(priority)] >= config_.priority_starvation_limit;
+        });
+
+        for (const OperationPriority priority: order) {
+            Selector& pending_submissions = pending_submissions_[to_index(priority)];
+
+            size_t submission_count = 0;
+            if (!pass.full && !pass.throttled) {
+                submission_count = prepare_submissions(pending_submissions, pass);
+            }
+
+            uint32_t& starved_pass_count = starved_pass_counts_[to_index(priority)];
+            if ((submission_count == 0) && pending_submissions.is_ready()) {
+                starved_pass_count += 1;
             }
             else {
-                return count; // Submission queue is full.
+                starved_pass_count = 0;
             }
         }
 
-        return ready_count;
+        update_capacity();
+        return pass;
     }
 
-    void Reactor::prepare_submission(struct io_uring_sqe& io_sqe) {
-        Event& event = *pending_submissions_.select();
-        Operation& operation = event.cast_user_data<Operation>();
+    void Reactor::prepare_cancels(SubmissionPass& pass) {
+        const size_t ready_count = pending_cancels_.ready_count();
+        for (size_t count = 0; count < ready_count; ++count) {
+            Event& event = *pending_cancels_.select();
+            Operation& operation = event.cast_user_data<Operation>();
+
+            // Restarted operations wait their turn like new ones.
+            if (operation.state() == OperationState::OPERATION_PENDING) {
+                schedule_operation(operation);
+                continue;
+            }
 
-        // Prepare the submission queue entry.
-        const OperationKey op_key = submitted_operation_table_.insert(operation);
-        operation.prepare(op_key, io_sqe);
-        io_uring_sqe_set_data64(&io_sqe, encode_operation_key(op_key));
+            constexpr size_t entry_count = 1;
+            if (!reserve_submission_space(entry_count, pass)) {
+                pending_cancels_.unselect(event);
+                break;
+            }
 
-        // Schedule the operation again in case it needs to submit again (cancel).
-        schedule_operation(operation);
+            constexpr bool linked = false;
+            prepare_submission(operation, linked);
+            record_submission(entry_count, pass);
+        }
     }
 
-    size_t Reactor::process_completions() {
-        size_t completion_count = 0;
+    size_t Reactor::prepare_submissions(Selector& pending_submissions, SubmissionPass& pass) {
+        size_t submission_count = 0;
 
-        std::array<struct io_uring_cqe*, 8> cqe_array;
-        while (int count = io_uring_peek_batch_cqe(&ring_, cqe_array.data(), cqe_array.size())) {
-            if (count > 0) {
-                for (int i = 0; i < count; ++i) {
-                    process_completion(*cqe_array[i]);
-                }
+        const size_t ready_count = pending_submissions.ready_count();
+        for (size_t count = 0; count < ready_count; ++count) {
+            Event& event = *pending_submissions.select();
+            Operation& operation = event.cast_user_data<Operation>();
+            assert(operation.state() == OperationState::OPERATION_PENDING);
+
+            // Linked chains and deadlines need several entries that have to be submitted together.
+            const size_t entry_count = count_submission_entries(operation);
+            if (entry_count > ring_.sq.ring_entries) {
+                // It could never be submitted in one go, so fail it instead of waiting for room.
+                constexpr uint32_t flags = 0;
+                operation.writable_event().reset();
+                operation.handle_result(operation.key(), -EINVAL, flags);
+                pass.rejected_count += 1;
+                continue;
+            }
+
+            // The rest wait behind the first operation that is held back, so that they stay in order.
+            if (!has_capacity(entry_count)) {
+                metrics_.throttle_count += 1;
+                pending_submissions.unselect(event);
+                pass.throttled = true;
+                break;
+            }
+
+            if (!reserve_submission_space(entry_count, pass)) {
+                pending_submissions.unselect(event);
+                break;
+            }
 
-                io_uring_cq_advance(&ring_, static_cast<unsigned>(count));
-                completion_count += static_cast<size_t>(count);
+            if (operation.type() == OperationType::LINKED) {
+                prepare_linked_submission(static_cast<LinkedOperation&>(operation));
             }
             else {
-                if (errno == EINTR) {
-                    continue; // Interrupted. Try again.
-                }
+                constexpr bool linked = false;
+                prepare_submission(operation, linked);
+            }
 
-                // Look at the error and add handling if it is recoverable.
-                // I think this is just reading the published sequence number
-                // and some memory fencing--shouldn't have many failure modes...
-                abort();
+            record_submission(entry_count, pass);
+            submission_count += entry_count;
+        }
+
+        return submission_count;
+    }
+
+    bool Reactor::reserve_submission_space(const size_t entry_count, SubmissionPass& pass) {
+        if (io_uring_sq_space_left(&ring_) < entry_count) {
+            // Hand what we have to the kernel to make room, and try again.
+            if (pass.unsubmitted_count > 0) {
+                metrics_.full_submission_count += 1;
+                submit();
+                pass.unsubmitted_count = 0;
+            }
+
+            if (io_uring_sq_space_left(&ring_) < entry_count) {
+                pass.full = true;
+                return false; // Submission queue is full (the polling thread hasn't caught up).
+            }
+        }
+
+        return true;
+    }
+
+    void Reactor::record_submission(const size_t entry_count, SubmissionPass& pass) {
+        in_flight_count_ += entry_count;
+        pass.submission_count += entry_count;
+        pass.unsubmitted_count += entry_count;
+    }
+
+    bool Reactor::has_capacity(const size_t entry_count) const {
+        // Always admit something, so that chains longer than the limit can make progress.
+        if (in_flight_count_ == 0) {
+            return true;
+        }
+
+        return !overflowing_ && ((in_flight_count_ + entry_count) <= in_flight_limit_);
+    }
+
+    void Reactor::update_capacity() {
+        // The kernel sets this when it had to spill completions. They are flushed back when
+        // we reap completions, so stop admitting until that happens.
+        const bool overflowing = IO_URING_READ_ONCE(*ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW;
+        if (overflowing && !overflowing_) {
+            metrics_.overflow_count += 1;
+        }
+        overflowing_ = overflowing;
+
+        if (has_capacity(1)) {
+            writable_event_.set();
+        }
+        else {
+            writable_event_.reset();
+        }
+    }
+
+    size_t Reactor::count_submission_entries(Operation& operation) {
+        if (operation.state() != OperationState::OPERATION_PENDING) {
+            return 1; // Cancel.
+        }
+
+        size_t entry_count = operation.entry_count() + (operation.has_deadline() ? 1 : 0);
+        if (operation.type() == OperationType::LINKED) {
+            LinkedOperation& linked_operation = static_cast<LinkedOperation&>(operation);
+
+            for (size_t index = 0; index < linked_operation.step_count(); ++index) {
+                entry_count += count_submission_entries(linked_operation.step(index));
+            }
+        }
+
+        return entry_count;
+    }
+
+    void Reactor::prepare_submission(Operation& operation, const bool linked) {
+        const bool has_deadline = (operation.state() == OperationState::OPERATION_PENDING) && operation.has_deadline();
+
+        if (FileDescriptor* target = operation.target(); target && !target->is_submitted()) {
+            if ((operation.state() == OperationState::OPERATION_PENDING) && config_.register_files_on_submit) {
+                (void)register_file_descriptor(*target); // Stays a plain descriptor if this fails.
+            }
+            target->mark_submitted();
+        }
+
+        // Prepare the submission queue entries. Batches submit several under the same key.
+        prepared_sqes_.clear();
+        for (size_t count = operation.entry_count(); count > 0; --count) {
+            prepared_sqes_.push_back(io_uring_get_sqe(&ring_));
+        }
+
+        const OperationKey op_key = insert_operation(operation);
+        switch (operation.type()) {
+#define X(SLAG_OPERATION_TYPE, SLAG_OPERATION_IMPL)                                \
+            case OperationType::SLAG_OPERATION_TYPE: {                             \
+                operation.prepare_as<SLAG_OPERATION_IMPL>(op_key, prepared_sqes_); \
+                break;                                                             \
+            }                                                                      \
+
+            SLAG_OPERATION_TYPES(X)
+#undef X
+        }
+
+        for (struct io_uring_sqe* io_sqe: prepared_sqes_) {
+            io_uring_sqe_set_data64(io_sqe, encode_operation_key(op_key));
+
+            if (linked) {
+                io_sqe->flags |= IOSQE_IO_LINK;
             }
         }
 
+        // A linked timeout has to directly follow the operation it bounds (the last entry of a batch).
+        if (has_deadline) {
+            prepared_sqes_.back()->flags |= IOSQE_IO_LINK;
+
+            struct io_uring_sqe& timeout_sqe = *io_uring_get_sqe(&ring_);
+            operation.prepare_deadline(timeout_sqe);
+            io_uring_sqe_set_data64(&timeout_sqe, encode_operation_key(LINK_TIMEOUT_OPERATION_KEY));
+
+            if (linked) {
+                timeout_sqe.flags |= IOSQE_IO_LINK; // Continue the chain.
+            }
+        }
+
+        // Wait for a cancel (or a restart) in case it needs to submit again.
+        pending_cancels_.insert<PollableType::WRITABLE>(operation);
+    }
+
+    void Reactor::prepare_linked_submission(LinkedOperation& linked_operation) {
+        for (size_t index = 0; index < linked_operation.step_count(); ++index) {
+            Operation& step = linked_operation.step(index);
+            assert(step.state() == OperationState::OPERATION_PENDING);
+
+            constexpr bool linked = true;
+            prepare_submission(step, linked);
+        }
+
+        constexpr bool linked = false;
+        prepare_submission(linked_operation, linked);
+    }
+
+    size_t Reactor::process_completions() {
+        // With deferred task work, completions are only posted when we enter the kernel. Spilled
+        // completions are also only flushed back into the ring then.
+        if (IO_URING_READ_ONCE(*ring_.sq.kflags) & (IORING_SQ_TASKRUN | IORING_SQ_CQ_OVERFLOW)) {
+            (void)io_uring_get_events(&ring_);
+        }
+
+        completion_batch_.clear();
+
+        // Harvest everything in the ring in one pass, and hand the entries back to the kernel
+        // at once since they are copied.
+        unsigned head;
+        unsigned completion_count = 0;
+        struct io_uring_cqe* io_cqe;
+        io_uring_for_each_cqe(&ring_, head, io_cqe) {
+            harvest_completion(*io_cqe);
+            ++completion_count;
+        }
+
+        if (completion_count == 0) {
+            return 0;
+        }
+
+        io_uring_cq_advance(&ring_, completion_count);
+        process_completion_batch();
+
+        metrics_.completion_count += completion_count;
+        metrics_.completion_batch_count += 1;
+        metrics_.completion_batch_size_max = std::max<size_t>(metrics_.completion_batch_size_max, completion_count);
+        metrics_.completion_batch_size_histogram[std::min<size_t>(std::bit_width(completion_count) - 1, Metrics::HISTOGRAM_SIZE - 1)] += 1;
+
         return completion_count;
     }
 
-    void Reactor::process_completion(struct io_uring_cqe& io_cqe) {
+    void Reactor::harvest_completion(const struct io_uring_cqe& io_cqe) {
         const OperationKey op_key = decode_operation_key(io_cqe.user_data);
 
         if (op_key == INTERRUPT_OPERATION_KEY) {
-            process_interrupt_completion(io_cqe, op_key);
+            process_interrupt_completion(io_cqe, op_key); // Submitted by another reactor.
+            return;
         }
-        else {
-            process_operation_completion(io_cqe, op_key);
+
+        if (!(io_cqe.flags & IORING_CQE_F_MORE)) {
+            assert(in_flight_count_ > 0);
+            in_flight_count_ -= 1;
+        }
+
+        if (op_key == LINK_TIMEOUT_OPERATION_KEY) {
+            return; // The operation it was attached to completes with -ECANCELED if this fired.
+        }
+
+        // Start pulling the operation in now. It isn't touched until the whole ring has been harvested.
+        Operation* operation = locate_operation(op_key);
+        __builtin_prefetch(operation, 1);
+
+        completion_batch_.push_back(Completion {
+            .operation = operation,
+            .op_key    = op_key,
+            .result    = io_cqe.res,
+            .flags     = io_cqe.flags,
+            .type      = OperationType{},
+        });
+    }
+
+    void Reactor::process_completion_batch() {
+        std::array<size_t, OPERATION_TYPE_COUNT + 1> offsets = {};
+        for (Completion& completion: completion_batch_) {
+            if (!completion.operation->uses_key(completion.op_key)) {
+                abort(); // Stale or corrupt key.
+            }
+
+            completion.type = completion.operation->type();
+            offsets[to_index(completion.type) + 1] += 1;
+        }
+
+        // Completions are handled in runs of the same type to improve I-Cache utilization. This
+        // is a counting sort, so the completions of each operation stay in order.
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        sorted_completion_batch_.resize(completion_batch_.size());
+        {
+            std::array<size_t, OPERATION_TYPE_COUNT + 1> cursors = offsets;
+            for (const Completion& completion: completion_batch_) {
+                sorted_completion_batch_[cursors[to_index(completion.type)]++] = completion;
+            }
+        }
+
+        for (size_t index = 0; index < OPERATION_TYPE_COUNT; ++index) {
+            const std::span<Completion> completions(
+                sorted_completion_batch_.data() + offsets[index],
+                sorted_completion_batch_.data() + offsets[index + 1]
+            );
+            if (completions.empty()) {
+                continue;
+            }
+
+            switch (static_cast<OperationType>(index)) {
+#define X(SLAG_OPERATION_TYPE, SLAG_OPERATION_IMPL)                                  \
+                case OperationType::SLAG_OPERATION_TYPE: {                           \
+                    process_operation_completions<SLAG_OPERATION_IMPL>(completions); \
+                    break;                                                           \
+                }                                                                    \
+
+                SLAG_OPERATION_TYPES(X)
+#undef X
+            }
+        }
+    }
+
+    template<typename OperationImpl>
+    void Reactor::process_operation_completions(std::span<Completion> completions) {
+        for (const Completion& completion: completions) {
+            OperationImpl& operation = static_cast<OperationImpl&>(*completion.operation);
+            const bool more = completion.flags & IORING_CQE_F_MORE;
+
+            // Zero-copy sends post their result with F_MORE, and then a notification once the kernel
+            // has released the buffer. The operation keeps its key until the notification arrives.
+            assert(!(completion.flags & IORING_CQE_F_NOTIF) || !more);
+
+            operation.template handle_result_as<OperationImpl>(completion.op_key, completion.result, completion.flags);
+
+            if (!more && !operation.uses_key(completion.op_key)) {
+                remove_operation(completion.op_key);
+
+                if (operation.is_abandoned() && operation.is_quiescent()) {
+                    destroy_operation(operation);
+                }
+            }
         }
     }
 
-    void Reactor::process_operation_completion(struct io_uring_cqe& io_cqe, const OperationKey op_key) {
-        const bool more = io_cqe.flags & IORING_CQE_F_MORE;
+    OperationKey Reactor::insert_operation(Operation& operation) {
+        switch (config_.operation_key_encoding) {
+            case OperationKeyEncoding::TABLE: {
+                return submitted_operation_table_.insert(operation);
+            }
+            case OperationKeyEncoding::TAGGED_POINTER: {
+                const OperationPointer pointer(&operation, operation.advance_key_generation() & OperationPointer::TAG_MASK);
+                return OperationKey(pointer.value());
+            }
+        }
 
-        Operation& operation = submitted_operation_table_.select(op_key);
-        operation.handle_result(op_key, io_cqe.res, more);
+        abort();
+    }
 
-        if (!more) {
-            submitted_operation_table_.remove(op_key);
+    Operation* Reactor::locate_operation(const OperationKey op_key) {
+        switch (config_.operation_key_encoding) {
+            case OperationKeyEncoding::TABLE: {
+                return &submitted_operation_table_.select(op_key);
+            }
+            case OperationKeyEncoding::TAGGED_POINTER: {
+                // Operations are not destroyed while completions are expected, so the pointer
+                // is safe to follow. The operation validates the generation tag.
+                return OperationPointer::from_value(op_key.value()).pointer();
+            }
+        }
 
-            if (operation.is_abandoned() && operation.is_quiescent()) {
-                destroy_operation(operation);
+        abort();
+    }
+
+    void Reactor::remove_operation(const OperationKey op_key) {
+        switch (config_.operation_key_encoding) {
+            case OperationKeyEncoding::TABLE: {
+                submitted_operation_table_.remove(op_key);
+                break;
+            }
+            case OperationKeyEncoding::TAGGED_POINTER: {
+                break; // Nothing to remove.
             }
         }
     }
 
-    void Reactor::process_interrupt_completion(struct io_uring_cqe& io_cqe, const OperationKey op_key) {
+    void Reactor::process_interrupt_completion(const struct io_uring_cqe& io_cqe, const OperationKey op_key) {
         assert(op_key == INTERRUPT_OPERATION_KEY);
 
         Interrupt interrupt;
@@ -1,24 +1,130 @@
 #pragma once
 
 #include <array>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <vector>
 #include <liburing.h>
 #include "slag/core.h"
+#include "slag/collections/tagged_pointer.h"
+#include "slag/memory/slab_pool.h"
 #include "operation.h"
+#include "operation_key.h"
 #include "operation_table.h"
+#include "operations/linked_operation.h"
+#include "file_table.h"
+#include "file_descriptor.h"
+#include "buffer_ring.h"
+#include "capabilities.h"
+#include "fixed_buffer_pool.h"
 #include "interrupt.h"
 
 namespace slag {
 
-    class Reactor {
+    struct ReactorConfig {
+        uint32_t submission_queue_size = 4096;
+        uint32_t completion_queue_size = 4 * 4096;
+        uint32_t fixed_file_table_size = 1024;
+
+        // File descriptors take a free fixed file slot the first time an operation on them is
+        // submitted, which saves a file lookup on every later submission. They keep using the
+        // plain descriptor when the table is full, or if the kernel doesn't support it.
+        bool register_files_on_submit = true;
+
+        // Slots after the fixed file table that the kernel hands out to files sent to this
+        // reactor by other threads (see FileTransfer), and to connections accepted directly.
+        uint32_t received_file_table_size = 256;
+
+        // Each reactor is only driven by its own event loop thread, which lets the kernel
+        // defer task work until we enter it to reap completions. These are probed, and
+        // dropped if the kernel doesn't support them.
+        bool single_issuer       = true;
+        bool defer_taskrun       = true;
+        bool cooperative_taskrun = true;
+        bool register_ring_fd    = true;
+
+        // Submissions are consumed by a kernel polling thread instead of `io_uring_enter`.
+        // Task work is run by that thread, so the deferral modes above are not used.
+        // Reactors in a runtime that enable this share one polling thread and worker pool.
+        bool                    submission_polling         = false;
+        std::optional<uint32_t> submission_polling_cpu     = std::nullopt;
+        uint32_t                submission_polling_idle_ms = 1000;
+
+        // Busy poll the network devices of the sockets used through this ring while waiting for
+        // completions, instead of waiting for their interrupts. Trades CPU for receive latency.
+        // Requires 6.9, and is skipped on older kernels.
+        std::optional<std::chrono::microseconds> napi_busy_poll_timeout = std::nullopt;
+        bool                                     napi_prefer_busy_poll  = false;
+
+        // New operations are held back while this many submission entries are awaiting their
+        // final completion, which bounds the memory and completion queue space they can use.
+        // Cancels are always admitted. Defaults to the completion queue size when zero.
+        uint32_t in_flight_limit = 0;
+
+        // Lower priority operations are submitted first once they have been passed over
+        // (by a full or throttled submission queue) this many times in a row.
+        uint32_t priority_starvation_limit = 8;
+
+        // Tagged pointers skip the operation table lookup for every submission and completion.
+        OperationKeyEncoding operation_key_encoding = OperationKeyEncoding::TABLE;
+    };
+
+    // The reactor is writable while it is admitting new operations. It stops when it reaches the
+    // in-flight limit, or the kernel has to spill completions because the completion queue is full,
+    // and tasks can wait on it to throttle themselves.
+    class Reactor : public Pollable<PollableType::WRITABLE> {
         Reactor(Reactor&&) = delete;
         Reactor(const Reactor&) = delete;
         Reactor& operator=(Reactor&&) = delete;
         Reactor& operator=(const Reactor&) = delete;
 
     public:
-        Reactor();
+        struct Metrics {
+            size_t throttle_count        = 0; // Submission passes held back by the in-flight limit.
+            size_t overflow_count        = 0; // Times the completion queue was found overflowing.
+            size_t full_submission_count = 0; // Early submissions because the submission queue was full.
+
+            // Completions harvested per poll. The histogram is bucketed by powers of two.
+            static constexpr size_t HISTOGRAM_SIZE = 16;
+
+            size_t                             completion_count          = 0;
+            size_t                             completion_batch_count    = 0;
+            size_t                             completion_batch_size_max = 0;
+            std::array<size_t, HISTOGRAM_SIZE> completion_batch_size_histogram = {};
+        };
+
+        // Optionally attach to the kernel workers of another ring (see IORING_SETUP_ATTACH_WQ).
+        explicit Reactor(const ReactorConfig& config = ReactorConfig{}, int shared_workers_file_descriptor = -1);
         ~Reactor();
 
+        // Must be called from the thread that will drive this reactor before it is used.
+        void enable();
+
+        const ReactorConfig& config() const;
+
+        // The setup flags and features that were negotiated with the kernel.
+        uint32_t setup_flags() const;
+        uint32_t features() const;
+        bool is_submission_polling() const;
+        bool is_busy_polling() const;
+
+        // The optional features this kernel supports. Factories use these to pick the fastest
+        // variant of an operation.
+        const CapabilitySet& capabilities() const;
+        bool has_capability(Capability capability) const;
+
+        Event& writable_event() override;
+
+        // Submission entries that have not received their final completion yet.
+        size_t in_flight_count() const;
+        size_t in_flight_limit() const;
+
+        // The most entries that an operation can submit together.
+        size_t submission_queue_size() const;
+
+        const Metrics& metrics() const;
+
         // Returns a file descriptor that can be used to notify this ring.
         int borrow_file_descriptor();
 
@@ -27,37 +133,150 @@ namespace slag {
         InterruptVector& interrupt_vector();
         InterruptState& interrupt_state(InterruptReason reason);
 
+        // Registered files are referenced by their slot in the ring's fixed file table,
+        // which saves the kernel an fdget/fdput for every submission that targets them.
+        // Returns false if the table is full or fixed files are not supported. Descriptors are
+        // also registered on their first submission (see `register_files_on_submit`).
+        bool register_file_descriptor(FileDescriptor& file_descriptor);
+        void unregister_file_descriptor(FileDescriptor& file_descriptor);
+
+        // Reserve slots for direct descriptors that are created by an operation (accept, socket, etc.).
+        std::optional<FixedFileIndex> allocate_fixed_file();
+        void deallocate_fixed_file(FixedFileIndex index);
+
+        // Creates a pool of buffers that the kernel selects from when data arrives. The ring
+        // lives as long as the reactor.
+        BufferRing& create_buffer_ring(size_t buffer_count, size_t buffer_size);
+
+        // Registers a pool of buffers with the ring. A ring has a single registered buffer
+        // table, so there can only be one of these per reactor.
+        FixedBufferPool& create_fixed_buffer_pool(size_t buffer_count, size_t buffer_size);
+        FixedBufferPool* fixed_buffer_pool();
+
+        // Operations are allocated from a slab pool per type, and recycled when they are destroyed.
         template<typename OperationImpl, typename... Args>
         Ref<OperationImpl> create_operation(Args&&... args);
         void schedule_operation(Operation& operation);
         void destroy_operation(Operation& operation);
 
+        // Returns null if no operations of this type have been created.
+        const SlabPool::Metrics* operation_pool_metrics(OperationType operation_type) const;
+
         // Returns true if any operations completed.
         // Optionally block until one completes, or we receive an interrupt.
         bool poll(bool non_blocking);
 
     private:
-        size_t prepare_submissions();
-        void prepare_submission(struct io_uring_sqe& io_sqe);
+        template<typename OperationImpl>
+        SlabPool& operation_pool();
+
+        void probe_capabilities();
+
+        void submit();
+        void drain();
+        struct SubmissionPass {
+            size_t submission_count  = 0;
+            size_t unsubmitted_count = 0;
+            size_t rejected_count    = 0; // Completed without being submitted.
+            bool   throttled         = false;
+            bool   full              = false;
+        };
+
+        SubmissionPass prepare_submissions();
+        void prepare_cancels(SubmissionPass& pass);
+        size_t prepare_submissions(Selector& pending_submissions, SubmissionPass& pass);
+        bool reserve_submission_space(size_t entry_count, SubmissionPass& pass);
+        void record_submission(size_t entry_count, SubmissionPass& pass);
+        size_t count_submission_entries(Operation& operation);
+        void prepare_submission(Operation& operation, bool linked);
+        void prepare_linked_submission(LinkedOperation& linked_operation);
+
+        struct Completion {
+            Operation*   operation;
+            OperationKey op_key;
+            int32_t      result;
+            uint32_t     flags;
+            OperationType type;
+        };
+
+        bool has_capacity(size_t entry_count) const;
+        void update_capacity();
 
         size_t process_completions();
-        void process_completion(struct io_uring_cqe& io_cqe);
+        void harvest_completion(const struct io_uring_cqe& io_cqe);
+        void process_completion_batch();
 
-        void process_operation_completion(struct io_uring_cqe& io_cqe, OperationKey op_key);
-        void process_interrupt_completion(struct io_uring_cqe& io_cqe, OperationKey op_key);
+        template<typename OperationImpl>
+        void process_operation_completions(std::span<Completion> completions);
+
+        // Map operations to and from the keys their submissions carry.
+        OperationKey insert_operation(Operation& operation);
+        Operation* locate_operation(OperationKey op_key);
+        void remove_operation(OperationKey op_key);
+        void process_interrupt_completion(const struct io_uring_cqe& io_cqe, OperationKey op_key);
 
     private:
+        using OperationPointer = TaggedPointer<Operation, OPERATION_KEY_TAG_BITS>;
+
+        ReactorConfig   config_;
         struct io_uring ring_;
-        Selector        pending_submissions_;
+        uint32_t        setup_flags_;
+        uint32_t        features_;
+        CapabilitySet   capabilities_;
+        bool            enabled_;
+        bool            busy_polling_;
+        size_t          in_flight_limit_;
+        size_t          in_flight_count_;
+        bool            overflowing_;
+        Event           writable_event_;
+        Metrics         metrics_;
+        FileTable       file_table_;
         OperationTable  submitted_operation_table_;
         InterruptVector interrupt_vector_;
+
+        // Pending operations are queued by priority. Submitted ones wait apart for a cancel, so
+        // that cancels don't have to be looked for behind operations that are held back.
+        std::array<Selector, OPERATION_PRIORITY_COUNT> pending_submissions_;
+        Selector                                       pending_cancels_;
+        std::array<uint32_t, OPERATION_PRIORITY_COUNT> starved_pass_counts_;
+
+        std::vector<struct io_uring_sqe*>        prepared_sqes_;
+        std::vector<Completion>                  completion_batch_;
+        std::vector<Completion>                  sorted_completion_batch_;
+        std::vector<std::unique_ptr<BufferRing>> buffer_rings_;
+        std::unique_ptr<FixedBufferPool>         fixed_buffer_pool_;
+
+        std::array<std::unique_ptr<SlabPool>, OPERATION_TYPE_COUNT> operation_pools_;
     };
 
     template<typename OperationImpl, typename... Args>
     Ref<OperationImpl> Reactor::create_operation(Args&&... args) {
-        return bind(
-            *(new OperationImpl(std::forward<Args>(args)...))
-        );
+        SlabPool& pool = operation_pool<OperationImpl>();
+
+        uint64_t key_generation;
+        void* storage = pool.allocate(key_generation);
+        try {
+            OperationImpl& operation = *(new(storage) OperationImpl(std::forward<Args>(args)...));
+            operation.set_key_generation(static_cast<uint8_t>(key_generation));
+            return bind(operation);
+        }
+        catch (...) {
+            pool.deallocate(storage, key_generation);
+            throw;
+        }
+    }
+
+    template<typename OperationImpl>
+    SlabPool& Reactor::operation_pool() {
+        constexpr OperationType operation_type = OperationTraits<OperationImpl>::TYPE;
+
+        std::unique_ptr<SlabPool>& pool = operation_pools_[to_index(operation_type)];
+        if (!pool) {
+            pool = std::make_unique<SlabPool>(sizeof(OperationImpl), alignof(OperationImpl));
+        }
+
+        assert(pool->block_size() >= sizeof(OperationImpl));
+        return *pool;
     }
 
 }
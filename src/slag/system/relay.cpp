@@ -0,0 +1,137 @@
+#include "relay.h"
+#include "slag/system/operation_factory.h"
+#include <algorithm>
+
+namespace slag {
+
+    Relay::Relay(Ref<FileDescriptor> source, Ref<FileDescriptor> sink)
+        : source_(std::move(source))
+        , sink_(std::move(sink))
+        , pipe_(make_pipe())
+        , chunk_size_(MIN_CHUNK_SIZE)
+        , buffered_byte_count_(0)
+        , relayed_byte_count_(0)
+        , sink_backed_up_(false)
+        , eof_(false)
+        , error_(0)
+    {
+    }
+
+    void Relay::run() {
+        SLAG_PT_BEGIN();
+
+        while (true) {
+            if (!fill_ && !eof_ && !error_ && (buffered_byte_count_ < pipe_->capacity())) {
+                start_fill();
+            }
+            if (!drain_ && !error_ && (buffered_byte_count_ > 0)) {
+                start_drain();
+            }
+            if (!fill_ && !drain_) {
+                break;
+            }
+
+            SLAG_PT_WAIT_READABLE(selector_);
+            while (Event* event = selector_.select()) {
+                if (fill_ && (event == &fill_->complete_event())) {
+                    handle_fill();
+                }
+                else {
+                    handle_drain();
+                }
+            }
+        }
+
+        if (error_) {
+            set_failure();
+        }
+
+        SLAG_PT_END();
+    }
+
+    uint64_t Relay::relayed_byte_count() const {
+        return relayed_byte_count_;
+    }
+
+    size_t Relay::pipe_capacity() const {
+        return pipe_->capacity();
+    }
+
+    int32_t Relay::error() const {
+        return error_;
+    }
+
+    void Relay::start_fill() {
+        const size_t length = std::min(chunk_size_, pipe_->capacity() - buffered_byte_count_);
+
+        fill_ = start_splice_operation(source_, pipe_->writer(), static_cast<uint32_t>(length));
+        selector_.insert<PollableType::COMPLETE>(*fill_);
+    }
+
+    void Relay::start_drain() {
+        drain_ = start_splice_operation(pipe_->reader(), sink_, static_cast<uint32_t>(buffered_byte_count_));
+        selector_.insert<PollableType::COMPLETE>(*drain_);
+    }
+
+    void Relay::handle_fill() {
+        const int32_t result = fill_->result();
+        const uint32_t length = fill_->length();
+        fill_.reset();
+
+        if (result < 0) {
+            error_ = result;
+            return;
+        }
+        if (result == 0) {
+            eof_ = true;
+            return;
+        }
+
+        buffered_byte_count_ += static_cast<size_t>(result);
+
+        // A full chunk means the source had more to give.
+        if (static_cast<uint32_t>(result) == length) {
+            grow();
+        }
+        else if (static_cast<uint32_t>(result) < (length / 2)) {
+            shrink();
+        }
+    }
+
+    void Relay::handle_drain() {
+        const int32_t result = drain_->result();
+        const uint32_t length = drain_->length();
+        drain_.reset();
+
+        if (result <= 0) {
+            error_ = result ? result : -EPIPE;
+            return;
+        }
+
+        buffered_byte_count_ -= static_cast<size_t>(result);
+        relayed_byte_count_ += static_cast<uint64_t>(result);
+
+        // A partial drain means the sink can't keep up, so stop reading ahead of it.
+        sink_backed_up_ = static_cast<uint32_t>(result) < length;
+        if (sink_backed_up_) {
+            shrink();
+        }
+    }
+
+    void Relay::grow() {
+        if (chunk_size_ < pipe_->capacity()) {
+            chunk_size_ = std::min(chunk_size_ * 2, pipe_->capacity());
+        }
+        else if (!sink_backed_up_ && (pipe_->capacity() < MAX_PIPE_CAPACITY)) {
+            // Both ends are keeping up, so give them a bigger pipe. The system limit might be lower.
+            if (pipe_->resize(pipe_->capacity() * 2)) {
+                chunk_size_ = pipe_->capacity();
+            }
+        }
+    }
+
+    void Relay::shrink() {
+        chunk_size_ = std::max(chunk_size_ / 2, MIN_CHUNK_SIZE);
+    }
+
+}
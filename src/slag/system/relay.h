@@ -0,0 +1,57 @@
+#pragma once
+
+#include "slag/core.h"
+#include "slag/object.h"
+#include "slag/resource.h"
+#include "slag/system/pipe.h"
+#include "slag/system/file_descriptor.h"
+#include "slag/system/operations/splice_operation.h"
+
+namespace slag {
+
+    // Shovels bytes from a source to a sink through a pipe until the source reaches EOF,
+    // without copying them into user space. Filling and draining the pipe overlap, and
+    // the fill size adapts to each end: it grows while the source keeps up with it, and
+    // shrinks when the source runs dry or the sink is backed up.
+    class Relay final : public ProtoTask {
+    public:
+        static constexpr size_t MIN_CHUNK_SIZE    = 4 * 1024;
+        static constexpr size_t MAX_PIPE_CAPACITY = 1024 * 1024;
+
+        Relay(Ref<FileDescriptor> source, Ref<FileDescriptor> sink);
+
+        void run() override;
+
+        uint64_t relayed_byte_count() const;
+
+        // Grows while both ends keep up, up to MAX_PIPE_CAPACITY.
+        size_t pipe_capacity() const;
+
+        // The error that stopped the relay, or zero.
+        int32_t error() const;
+
+    private:
+        void start_fill();
+        void start_drain();
+        void handle_fill();
+        void handle_drain();
+
+        void grow();
+        void shrink();
+
+    private:
+        Ref<FileDescriptor>  source_;
+        Ref<FileDescriptor>  sink_;
+        Ref<Pipe>            pipe_;
+        Ptr<SpliceOperation> fill_;
+        Ptr<SpliceOperation> drain_;
+        Selector             selector_;
+        size_t               chunk_size_;
+        size_t               buffered_byte_count_;
+        uint64_t             relayed_byte_count_;
+        bool                 sink_backed_up_;
+        bool                 eof_;
+        int32_t              error_;
+    };
+
+}
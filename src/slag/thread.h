@@ -24,6 +24,8 @@ namespace slag {
     struct ThreadConfig {
         std::optional<std::string> name;
         std::optional<std::span<size_t>> cpu_affinities = std::nullopt;
+        ReactorConfig reactor = ReactorConfig{};
+        IdlePolicy idle_policy = IdlePolicy{};
     };
 
     class Thread {
@@ -78,6 +80,7 @@ namespace slag {
                     .domain = context.domain(),
                     .fabric = std::move(fabric_),
                     .reactor = std::move(reactor_),
+                    .idle_policy = config_.idle_policy,
                 });
 
                 root_task = std::make_unique<RootTask>(std::forward<Args>(args)...);